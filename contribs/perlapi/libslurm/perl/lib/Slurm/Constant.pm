@@ -1216,6 +1216,8 @@ head2 SLURM ERRNO
 
 =item * ESLURMD_STEP_NOTSUSPENDED               4029
 
+=item * ESLURMD_BCAST_CACHE_MISS                4030
+
 =back
 
 =head3 slurmd errors in user batch job
@@ -247,6 +247,7 @@ enum {
 	ESLURMD_JOB_NOTRUNNING,
 	ESLURMD_STEP_SUSPENDED,
 	ESLURMD_STEP_NOTSUSPENDED,
+	ESLURMD_BCAST_CACHE_MISS,
 
 	/* slurmd errors in user batch job */
 	ESCRIPT_CHDIR_FAILED =			4100,
@@ -285,6 +285,10 @@ typedef struct {
 	List jobname_list;	/* list of char * */
 	uint32_t nodes_max;     /* number of nodes high range */
 	uint32_t nodes_min;     /* number of nodes low range */
+	char *page_cluster;	/* cluster of page_jobid */
+	uint32_t page_jobid;	/* only return jobs after this one */
+	uint32_t page_size;	/* return about this many jobs per call,
+				 * 0 for all of them */
 	List partition_list;	/* list of char * */
 	List qos_list;  	/* list of char * */
 	List resv_list;		/* list of char * */
@@ -1224,6 +1228,11 @@ typedef struct {
 #define ROLLUP_DAY	1
 #define ROLLUP_MONTH	2
 #define ROLLUP_COUNT	3
+
+/* slurmdbd RPC lanes, see slurmdb_stats_rec_t */
+#define SLURMDB_LANE_CTLD	0	/* slurmctld connections */
+#define SLURMDB_LANE_USER	1	/* everything else (sacct, sreport...) */
+#define SLURMDB_LANE_COUNT	2
 typedef struct rollup_stats {
 	uint32_t rollup_time[ROLLUP_COUNT];
 } rollup_stats_t;
@@ -1241,6 +1250,12 @@ typedef struct {
 	uint32_t *rpc_user_id;		/* User ID issuing RPC */
 	uint32_t *rpc_user_cnt;		/* count of RPCs processed */
 	uint64_t *rpc_user_time;	/* total usecs this user's RPCs */
+
+	uint32_t *lane_cnt;		/* Length should be SLURMDB_LANE_COUNT */
+	uint64_t *lane_time;		/* Length should be SLURMDB_LANE_COUNT */
+	uint64_t *lane_max_time;	/* Length should be SLURMDB_LANE_COUNT */
+	uint64_t *lane_wait_time;	/* Length should be SLURMDB_LANE_COUNT,
+					 * usecs spent waiting for a slot */
 } slurmdb_stats_rec_t;
 
 
@@ -61,6 +61,7 @@
 #include "slurm/slurm_errno.h"
 #include "src/common/forward.h"
 #include "src/common/hostlist.h"
+#include "src/common/list.h"
 #include "src/common/log.h"
 #include "src/common/macros.h"
 #include "src/common/read_config.h"
@@ -74,22 +75,56 @@
 #include "src/common/xstring.h"
 
 #include "file_bcast.h"
+#include "sha256.h"
 
 #define MAX_THREADS      8	/* These can be huge messages, so
 				 * only run MAX_THREADS at one time */
 
+#define MAX_STREAMS      8	/* Maximum number of blocks in flight */
+
+/* Older slurmd write each block at the current file offset */
+#define STREAMS_MIN_VERSION SLURM_VERSION_NUM(18, 8, 0)
+
+typedef struct bcast_block {
+	char *buffer;		/* block data, possibly compressed */
+	uint32_t block_len;	/* length of buffer */
+	uint32_t block_no;	/* block sequence number, starting at 1 */
+	uint64_t block_offset;	/* offset of block data in source file */
+	uint16_t compress;	/* compression library used for buffer */
+	bool last_block;	/* last block of the file */
+	int32_t orig_len;	/* uncompressed length of block */
+	char *hash;		/* SHA-256 of uncompressed data, if caching */
+} bcast_block_t;
+
 int block_len;				/* block size */
 int fd;					/* source file descriptor */
 void *src;				/* source mmap'd address */
 struct stat f_stat;			/* source file stats */
 job_sbcast_cred_msg_t *sbcast_cred;	/* job alloc info and sbcast cred */
 
+/* state shared by the block reader and sender threads */
+static pthread_mutex_t block_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t  block_cond  = PTHREAD_COND_INITIALIZER;
+static List block_queue = NULL;		/* blocks ready to be sent */
+static int  queue_depth = 0;		/* maximum blocks read ahead */
+static int  blocks_in_flight = 0;	/* blocks being sent */
+static int  block_rc = SLURM_SUCCESS;	/* first transfer failure */
+static bool first_block_done = false;
+static bool reader_done = false;
+static file_bcast_msg_t bcast_msg_tmpl;	/* fields common to every block */
+static uint64_t size_compressed = 0, size_uncompressed = 0;
+static uint32_t time_compression = 0;
+static bool cache_blocks = false;	/* probe slurmd block caches first */
+static uint64_t cache_hits = 0, cache_probes = 0; /* node blocks */
+
 static int   _bcast_file(struct bcast_parameters *params);
+static void  _free_block(void *x);
 static int   _file_bcast(struct bcast_parameters *params,
-			 file_bcast_msg_t *bcast_msg,
-			 job_sbcast_cred_msg_t *sbcast_cred);
+			 file_bcast_msg_t *bcast_msg, char *node_list,
+			 hostlist_t miss_hl);
 static int   _file_state(struct bcast_parameters *params);
 static int   _get_job_info(struct bcast_parameters *params);
+static bool  _streams_supported(void);
 
 
 static int _file_state(struct bcast_parameters *params)
@@ -127,6 +162,17 @@ static int _file_state(struct bcast_parameters *params)
 	return SLURM_SUCCESS;
 }
 
+static void _free_block(void *x)
+{
+	bcast_block_t *block = (bcast_block_t *) x;
+
+	if (!block)
+		return;
+	xfree(block->buffer);
+	xfree(block->hash);
+	xfree(block);
+}
+
 /* get details about this slurm job: jobid and allocated node */
 static int _get_job_info(struct bcast_parameters *params)
 {
@@ -178,10 +224,54 @@ static int _get_job_info(struct bcast_parameters *params)
 	return rc;
 }
 
-/* Issue the RPC to transfer the file's data */
+/*
+ * Return true if every node of the job runs a slurmd which writes blocks at
+ * their own offset, so blocks may be sent out of order
+ */
+static bool _streams_supported(void)
+{
+	node_info_msg_t *node_msg = NULL;
+	node_info_t *node_ptr;
+	hostlist_t hl;
+	int i, major, minor;
+	bool supported = true;
+
+	if (slurm_load_node((time_t) 0, &node_msg, SHOW_ALL)) {
+		verbose("Can't load node versions: %s",
+			slurm_strerror(slurm_get_errno()));
+		return false;
+	}
+
+	hl = hostlist_create(sbcast_cred->node_list);
+	for (i = 0; i < node_msg->record_count; i++) {
+		node_ptr = &node_msg->node_array[i];
+		if (!node_ptr->name || (hostlist_find(hl, node_ptr->name) < 0))
+			continue;
+		if (!node_ptr->version ||
+		    (sscanf(node_ptr->version, "%d.%d", &major, &minor) != 2)||
+		    (SLURM_VERSION_NUM(major, minor, 0) <
+		     STREAMS_MIN_VERSION)) {
+			verbose("Node %s runs Slurm version %s, sending one block at a time",
+				node_ptr->name, node_ptr->version);
+			supported = false;
+			break;
+		}
+	}
+	hostlist_destroy(hl);
+	slurm_free_node_info_msg(node_msg);
+
+	return supported;
+}
+
+/*
+ * Issue the RPC to transfer the file's data
+ * IN node_list - nodes to send the block to
+ * IN miss_hl - if set, collect nodes which do not have the block cached here
+ *		rather than treating them as failures
+ */
 static int _file_bcast(struct bcast_parameters *params,
-		       file_bcast_msg_t *bcast_msg,
-		       job_sbcast_cred_msg_t *sbcast_cred)
+		       file_bcast_msg_t *bcast_msg, char *node_list,
+		       hostlist_t miss_hl)
 {
 	List ret_list = NULL;
 	ListIterator itr;
@@ -193,8 +283,7 @@ static int _file_bcast(struct bcast_parameters *params,
 	msg.data = bcast_msg;
 	msg.msg_type = REQUEST_FILE_BCAST;
 
-	ret_list = slurm_send_recv_msgs(
-		sbcast_cred->node_list, &msg, params->timeout, true);
+	ret_list = slurm_send_recv_msgs(node_list, &msg, params->timeout, true);
 	if (ret_list == NULL) {
 		error("slurm_send_recv_msgs: %m");
 		exit(1);
@@ -206,6 +295,10 @@ static int _file_bcast(struct bcast_parameters *params,
 					       ret_data_info->data);
 		if (msg_rc == SLURM_SUCCESS)
 			continue;
+		if (miss_hl && (msg_rc == ESLURMD_BCAST_CACHE_MISS)) {
+			hostlist_push_host(miss_hl, ret_data_info->node_name);
+			continue;
+		}
 
 		error("REQUEST_FILE_BCAST(%s): %s",
 		      ret_data_info->node_name,
@@ -227,10 +320,11 @@ static int _get_block_none(char **buffer, int *orig_len, bool *more)
 	int size;
 
 	if (remaining < 0) {
-		*buffer = xmalloc(block_len);
 		remaining = f_stat.st_size;
 		position = src;
 	}
+	if (!*buffer)
+		*buffer = xmalloc(block_len);
 
 	size = MIN(block_len, remaining);
 	memcpy(*buffer, position, size);
@@ -274,9 +368,10 @@ static int _get_block_zlib(struct bcast_parameters *params,
 	if (remaining < 0) {
 		remaining = f_stat.st_size;
 		max_out = deflateBound(&strm, block_len);
-		*buffer = xmalloc(max_out);
 		position = src;
 	}
+	if (!*buffer)
+		*buffer = xmalloc(max_out);
 
 	chunk_remaining = MIN(block_len, remaining);
 	out_remaining = max_out;
@@ -331,8 +426,9 @@ static int _get_block_lz4(struct bcast_parameters *params,
 	if (remaining < 0) {
 		position = src;
 		remaining = f_stat.st_size;
-		*buffer = xmalloc(block_len);
 	}
+	if (!*buffer)
+		*buffer = xmalloc(block_len);
 
 	/* intentionally limit decompressed size to 10x compressed
 	 * to avoid problems on receive size when decompressed */
@@ -377,69 +473,232 @@ static int _next_block(struct bcast_parameters *params,
 	return _get_block_none(buffer, orig_len, more);
 }
 
-/* read and broadcast the file */
-static int _bcast_file(struct bcast_parameters *params)
+/* read (and optionally compress) blocks ahead of the sender threads */
+static void *_block_reader(void *arg)
 {
-	int rc = SLURM_SUCCESS;
-	file_bcast_msg_t bcast_msg;
-	char *buffer = NULL;
-	int32_t orig_len = 0;
-	uint64_t size_uncompressed = 0, size_compressed = 0;
-	uint32_t time_compression = 0;
+	struct bcast_parameters *params = (struct bcast_parameters *) arg;
+	bcast_block_t *block;
+	uint32_t block_no = 1;
+	uint64_t block_offset = 0;
 	bool more = true;
 	DEF_TIMERS;
 
+	while (more) {
+		slurm_mutex_lock(&block_mutex);
+		while (!block_rc && (list_count(block_queue) >= queue_depth))
+			slurm_cond_wait(&block_cond, &block_mutex);
+		if (block_rc) {
+			slurm_mutex_unlock(&block_mutex);
+			break;
+		}
+		slurm_mutex_unlock(&block_mutex);
+
+		block = xmalloc(sizeof(bcast_block_t));
+		START_TIMER;
+		block->block_len = _next_block(params, &block->buffer,
+					       &block->orig_len, &more);
+		END_TIMER;
+		block->block_no = block_no++;
+		block->block_offset = block_offset;
+		block->compress = params->compress;
+		block->last_block = !more;
+		if (cache_blocks && (block->orig_len > 0)) {
+			block->hash = xmalloc(SHA256_HEX_LEN);
+			sha256_hex((char *) src + block_offset, block->orig_len,
+				   block->hash);
+		}
+		block_offset += block->orig_len;
+		debug("block %u, size %u", block->block_no, block->block_len);
+
+		slurm_mutex_lock(&block_mutex);
+		time_compression += DELTA_TIMER;
+		size_uncompressed += block->orig_len;
+		size_compressed += block->block_len;
+		list_enqueue(block_queue, block);
+		slurm_cond_broadcast(&block_cond);
+		slurm_mutex_unlock(&block_mutex);
+	}
+
+	slurm_mutex_lock(&block_mutex);
+	reader_done = true;
+	slurm_cond_broadcast(&block_cond);
+	slurm_mutex_unlock(&block_mutex);
+
+	return NULL;
+}
+
+/*
+ * Get the next block which may be sent now. The first block registers the
+ * file on the compute nodes and the last block closes it, so the first block
+ * must complete before any other is sent and the last block is only sent
+ * once every other block has completed.
+ * RET block to send or NULL when done or after a failure
+ */
+static bcast_block_t *_next_sendable_block(void)
+{
+	bcast_block_t *block = NULL;
+
+	slurm_mutex_lock(&block_mutex);
+	while (!block_rc) {
+		block = list_peek(block_queue);
+		if (!block) {
+			if (reader_done)
+				break;
+		} else if (((block->block_no == 1) || first_block_done) &&
+			   (!block->last_block || !blocks_in_flight)) {
+			(void) list_dequeue(block_queue);
+			blocks_in_flight++;
+			slurm_cond_broadcast(&block_cond);
+			break;
+		}
+		block = NULL;
+		slurm_cond_wait(&block_cond, &block_mutex);
+	}
+	slurm_mutex_unlock(&block_mutex);
+
+	return block;
+}
+
+/*
+ * Offer a block's hash to every node, nodes with the block in their cache
+ * write it from there. Then send the block's data to the remaining nodes.
+ */
+static int _send_cached_block(struct bcast_parameters *params,
+			      file_bcast_msg_t *bcast_msg)
+{
+	file_bcast_msg_t probe_msg;
+	hostlist_t miss_hl = hostlist_create(NULL);
+	char *miss_nodes;
+	int miss_cnt, rc;
+
+	memcpy(&probe_msg, bcast_msg, sizeof(file_bcast_msg_t));
+	probe_msg.block = NULL;
+	probe_msg.block_len = 0;
+	probe_msg.cache_probe = 1;
+	rc = _file_bcast(params, &probe_msg, sbcast_cred->node_list, miss_hl);
+
+	miss_cnt = hostlist_count(miss_hl);
+	slurm_mutex_lock(&block_mutex);
+	cache_probes += sbcast_cred->node_cnt;
+	cache_hits += sbcast_cred->node_cnt - MIN(miss_cnt,
+						  sbcast_cred->node_cnt);
+	slurm_mutex_unlock(&block_mutex);
+
+	if ((rc == SLURM_SUCCESS) && miss_cnt) {
+		miss_nodes = hostlist_ranged_string_xmalloc(miss_hl);
+		debug("block %u not cached on %d nodes",
+		      bcast_msg->block_no, miss_cnt);
+		rc = _file_bcast(params, bcast_msg, miss_nodes, NULL);
+		xfree(miss_nodes);
+	}
+	hostlist_destroy(miss_hl);
+
+	return rc;
+}
+
+static void *_block_sender(void *arg)
+{
+	struct bcast_parameters *params = (struct bcast_parameters *) arg;
+	file_bcast_msg_t bcast_msg;
+	bcast_block_t *block;
+	int rc;
+
+	while ((block = _next_sendable_block())) {
+		memcpy(&bcast_msg, &bcast_msg_tmpl, sizeof(file_bcast_msg_t));
+		bcast_msg.block		= block->buffer;
+		bcast_msg.block_len	= block->block_len;
+		bcast_msg.block_no	= block->block_no;
+		bcast_msg.block_offset	= block->block_offset;
+		bcast_msg.compress	= block->compress;
+		bcast_msg.last_block	= block->last_block;
+		bcast_msg.uncomp_len	= block->orig_len;
+		bcast_msg.block_hash	= block->hash;
+
+		if (block->hash)
+			rc = _send_cached_block(params, &bcast_msg);
+		else
+			rc = _file_bcast(params, &bcast_msg,
+					 sbcast_cred->node_list, NULL);
+
+		slurm_mutex_lock(&block_mutex);
+		blocks_in_flight--;
+		if (block->block_no == 1)
+			first_block_done = true;
+		block_rc = MAX(block_rc, rc);
+		slurm_cond_broadcast(&block_cond);
+		slurm_mutex_unlock(&block_mutex);
+
+		_free_block(block);
+	}
+
+	return NULL;
+}
+
+/*
+ * read and broadcast the file
+ *
+ * Reading and compression run in their own thread, up to params->streams
+ * blocks are transmitted concurrently by the sender threads.
+ */
+static int _bcast_file(struct bcast_parameters *params)
+{
+	pthread_t reader_tid, *sender_tids;
+	int i, streams;
+	DEF_TIMERS;
+
 	if (params->block_size)
 		block_len = MIN(params->block_size, f_stat.st_size);
 	else
 		block_len = MIN((512 * 1024), f_stat.st_size);
 
-	memset(&bcast_msg, 0, sizeof(file_bcast_msg_t));
-	bcast_msg.fname		= params->dst_fname;
-	bcast_msg.block_no	= 1;
-	bcast_msg.force		= params->force;
-	bcast_msg.modes		= f_stat.st_mode;
-	bcast_msg.uid		= f_stat.st_uid;
-	bcast_msg.user_name	= uid_to_string(f_stat.st_uid);
-	bcast_msg.gid		= f_stat.st_gid;
-	bcast_msg.file_size	= f_stat.st_size;
-	bcast_msg.cred          = sbcast_cred->sbcast_cred;
+	memset(&bcast_msg_tmpl, 0, sizeof(file_bcast_msg_t));
+	bcast_msg_tmpl.fname		= params->dst_fname;
+	bcast_msg_tmpl.force		= params->force;
+	bcast_msg_tmpl.modes		= f_stat.st_mode;
+	bcast_msg_tmpl.uid		= f_stat.st_uid;
+	bcast_msg_tmpl.user_name	= uid_to_string(f_stat.st_uid);
+	bcast_msg_tmpl.gid		= f_stat.st_gid;
+	bcast_msg_tmpl.file_size	= f_stat.st_size;
+	bcast_msg_tmpl.cred		= sbcast_cred->sbcast_cred;
 
 	if (params->preserve) {
-		bcast_msg.atime     = f_stat.st_atime;
-		bcast_msg.mtime     = f_stat.st_mtime;
+		bcast_msg_tmpl.atime     = f_stat.st_atime;
+		bcast_msg_tmpl.mtime     = f_stat.st_mtime;
 	}
 
 	if (!params->fanout)
 		params->fanout = MAX_THREADS;
 	slurm_set_tree_width(MIN(MAX_THREADS, params->fanout));
 
-	while (more) {
-		START_TIMER;
-		bcast_msg.block_len = _next_block(params, &buffer, &orig_len,
-						  &more);
-		END_TIMER;
-		time_compression += DELTA_TIMER;
-		size_uncompressed += orig_len;
-		size_compressed += bcast_msg.block_len;
-		debug("block %u, size %u", bcast_msg.block_no,
-		      bcast_msg.block_len);
-		bcast_msg.compress = params->compress;
-		bcast_msg.uncomp_len = orig_len;
-		bcast_msg.block = buffer;
-		if (!more)
-			bcast_msg.last_block = 1;
-
-		rc = _file_bcast(params, &bcast_msg, sbcast_cred);
-		if (rc != SLURM_SUCCESS)
-			break;
-		if (bcast_msg.last_block)
-			break;	/* end of file */
-		bcast_msg.block_no++;
-		bcast_msg.block_offset += orig_len;
-	}
-	xfree(bcast_msg.user_name);
-	xfree(buffer);
+	streams = MIN(MAX(params->streams, 1), MAX_STREAMS);
+	if ((streams > 1) && !_streams_supported())
+		streams = 1;
+	verbose("streams    = %d", streams);
+
+	block_queue = list_create(_free_block);
+	queue_depth = streams + 1;
+	blocks_in_flight = 0;
+	block_rc = SLURM_SUCCESS;
+	first_block_done = false;
+	reader_done = false;
+	size_compressed = size_uncompressed = 0;
+	time_compression = 0;
+	cache_hits = cache_probes = 0;
+
+	START_TIMER;
+	slurm_thread_create(&reader_tid, _block_reader, params);
+	sender_tids = xmalloc(sizeof(pthread_t) * streams);
+	for (i = 0; i < streams; i++)
+		slurm_thread_create(&sender_tids[i], _block_sender, params);
+
+	for (i = 0; i < streams; i++)
+		pthread_join(sender_tids[i], NULL);
+	pthread_join(reader_tid, NULL);
+	END_TIMER;
+	xfree(sender_tids);
+
+	FREE_NULL_LIST(block_queue);
+	xfree(bcast_msg_tmpl.user_name);
 
 	if (size_uncompressed && (params->compress != 0)) {
 		int64_t pct = (int64_t) size_uncompressed - size_compressed;
@@ -453,8 +712,14 @@ static int _bcast_file(struct bcast_parameters *params)
 			size_uncompressed, size_compressed, (int) pct,
 			time_compression);
 	}
+	if (cache_probes) {
+		verbose("%"PRIu64" of %"PRIu64" node blocks found in slurmd caches",
+			cache_hits, cache_probes);
+	}
+	if (block_rc == SLURM_SUCCESS)
+		verbose("File transferred in %s", TIME_STR);
 
-	return rc;
+	return block_rc;
 }
 
 
@@ -543,8 +808,14 @@ static int _decompress_data_lz4(file_bcast_msg_t *req)
 
 extern int bcast_file(struct bcast_parameters *params)
 {
+	char *sbcast_params;
 	int rc;
 
+	/* slurmd caches blocks when SbcastParameters=CacheDir is set */
+	sbcast_params = slurm_get_sbcast_parameters();
+	cache_blocks = (xstrcasestr(sbcast_params, "CacheDir=") != NULL);
+	xfree(sbcast_params);
+
 	if ((rc = _file_state(params)) != SLURM_SUCCESS)
 		return rc;
 	if ((rc = _get_job_info(params)) != SLURM_SUCCESS)
@@ -51,6 +51,7 @@ struct bcast_parameters {
 	bool preserve;
 	char *src_fname;
 	uint32_t step_id;
+	int streams;			/* blocks in flight at once */
 	int timeout;
 	int verbose;
 };
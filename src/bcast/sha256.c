@@ -0,0 +1,206 @@
+/*****************************************************************************\
+ *  sha256.c - SHA-256 message digest (FIPS 180-4)
+ *****************************************************************************
+ *  Copyright (C) 2018 SchedMD LLC.
+ *
+ *  This file is part of Slurm, a resource management program.
+ *  For details, see <https://slurm.schedmd.com/>.
+ *  Please also read the included file: DISCLAIMER.
+ *
+ *  Slurm is free software; you can redistribute it and/or modify it under
+ *  the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  In addition, as a special exception, the copyright holders give permission
+ *  to link the code of portions of this program with the OpenSSL library under
+ *  certain conditions as described in each individual source file, and
+ *  distribute linked combinations including the two. You must obey the GNU
+ *  General Public License in all respects for all of the code used other than
+ *  OpenSSL. If you modify file(s) with this exception, you may extend this
+ *  exception to your version of the file(s), but you are not obligated to do
+ *  so. If you do not wish to do so, delete this exception statement from your
+ *  version.  If you delete this exception statement from all source files in
+ *  the program, then also delete it here.
+ *
+ *  Slurm is distributed in the hope that it will be useful, but WITHOUT ANY
+ *  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *  FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ *  details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with Slurm; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA.
+\*****************************************************************************/
+
+#include <string.h>
+
+#include "sha256.h"
+
+typedef struct {
+	uint32_t state[8];
+	uint64_t bit_len;
+	uint8_t block[64];
+	size_t block_used;
+} sha256_ctx_t;
+
+static const uint32_t k[64] = {
+	0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5,
+	0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+	0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+	0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+	0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc,
+	0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+	0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7,
+	0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+	0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+	0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+	0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3,
+	0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+	0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5,
+	0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+	0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+	0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+#define ROTR(x, n)	(((x) >> (n)) | ((x) << (32 - (n))))
+#define CH(x, y, z)	(((x) & (y)) ^ (~(x) & (z)))
+#define MAJ(x, y, z)	(((x) & (y)) ^ ((x) & (z)) ^ ((y) & (z)))
+#define EP0(x)		(ROTR(x, 2) ^ ROTR(x, 13) ^ ROTR(x, 22))
+#define EP1(x)		(ROTR(x, 6) ^ ROTR(x, 11) ^ ROTR(x, 25))
+#define SIG0(x)		(ROTR(x, 7) ^ ROTR(x, 18) ^ ((x) >> 3))
+#define SIG1(x)		(ROTR(x, 17) ^ ROTR(x, 19) ^ ((x) >> 10))
+
+static void _transform(sha256_ctx_t *ctx, const uint8_t *data)
+{
+	uint32_t a, b, c, d, e, f, g, h, t1, t2, m[64];
+	int i;
+
+	for (i = 0; i < 16; i++) {
+		m[i] = ((uint32_t) data[i * 4] << 24) |
+		       ((uint32_t) data[i * 4 + 1] << 16) |
+		       ((uint32_t) data[i * 4 + 2] << 8) |
+		       ((uint32_t) data[i * 4 + 3]);
+	}
+	for ( ; i < 64; i++)
+		m[i] = SIG1(m[i - 2]) + m[i - 7] + SIG0(m[i - 15]) + m[i - 16];
+
+	a = ctx->state[0];
+	b = ctx->state[1];
+	c = ctx->state[2];
+	d = ctx->state[3];
+	e = ctx->state[4];
+	f = ctx->state[5];
+	g = ctx->state[6];
+	h = ctx->state[7];
+
+	for (i = 0; i < 64; i++) {
+		t1 = h + EP1(e) + CH(e, f, g) + k[i] + m[i];
+		t2 = EP0(a) + MAJ(a, b, c);
+		h = g;
+		g = f;
+		f = e;
+		e = d + t1;
+		d = c;
+		c = b;
+		b = a;
+		a = t1 + t2;
+	}
+
+	ctx->state[0] += a;
+	ctx->state[1] += b;
+	ctx->state[2] += c;
+	ctx->state[3] += d;
+	ctx->state[4] += e;
+	ctx->state[5] += f;
+	ctx->state[6] += g;
+	ctx->state[7] += h;
+}
+
+static void _init(sha256_ctx_t *ctx)
+{
+	ctx->state[0] = 0x6a09e667;
+	ctx->state[1] = 0xbb67ae85;
+	ctx->state[2] = 0x3c6ef372;
+	ctx->state[3] = 0xa54ff53a;
+	ctx->state[4] = 0x510e527f;
+	ctx->state[5] = 0x9b05688c;
+	ctx->state[6] = 0x1f83d9ab;
+	ctx->state[7] = 0x5be0cd19;
+	ctx->bit_len = 0;
+	ctx->block_used = 0;
+}
+
+static void _update(sha256_ctx_t *ctx, const uint8_t *data, size_t len)
+{
+	size_t bite;
+
+	ctx->bit_len += (uint64_t) len * 8;
+
+	/* complete any partial block left by a previous call */
+	if (ctx->block_used) {
+		bite = 64 - ctx->block_used;
+		if (bite > len)
+			bite = len;
+		memcpy(ctx->block + ctx->block_used, data, bite);
+		ctx->block_used += bite;
+		data += bite;
+		len -= bite;
+		if (ctx->block_used < 64)
+			return;
+		_transform(ctx, ctx->block);
+		ctx->block_used = 0;
+	}
+
+	/* digest whole blocks directly from the caller's buffer */
+	while (len >= 64) {
+		_transform(ctx, data);
+		data += 64;
+		len -= 64;
+	}
+
+	memcpy(ctx->block, data, len);
+	ctx->block_used = len;
+}
+
+static void _final(sha256_ctx_t *ctx, uint8_t *digest)
+{
+	uint64_t bit_len = ctx->bit_len;
+	int i;
+
+	ctx->block[ctx->block_used++] = 0x80;
+	if (ctx->block_used > 56) {
+		memset(ctx->block + ctx->block_used, 0, 64 - ctx->block_used);
+		_transform(ctx, ctx->block);
+		ctx->block_used = 0;
+	}
+	memset(ctx->block + ctx->block_used, 0, 56 - ctx->block_used);
+	for (i = 0; i < 8; i++)
+		ctx->block[63 - i] = (uint8_t) (bit_len >> (i * 8));
+	_transform(ctx, ctx->block);
+
+	for (i = 0; i < 8; i++) {
+		digest[i * 4]     = (uint8_t) (ctx->state[i] >> 24);
+		digest[i * 4 + 1] = (uint8_t) (ctx->state[i] >> 16);
+		digest[i * 4 + 2] = (uint8_t) (ctx->state[i] >> 8);
+		digest[i * 4 + 3] = (uint8_t) (ctx->state[i]);
+	}
+}
+
+extern void sha256_hex(const void *data, size_t len, char *hex)
+{
+	static const char digits[] = "0123456789abcdef";
+	sha256_ctx_t ctx;
+	uint8_t digest[SHA256_DIGEST_LEN];
+	int i;
+
+	_init(&ctx);
+	_update(&ctx, (const uint8_t *) data, len);
+	_final(&ctx, digest);
+
+	for (i = 0; i < SHA256_DIGEST_LEN; i++) {
+		hex[i * 2]     = digits[digest[i] >> 4];
+		hex[i * 2 + 1] = digits[digest[i] & 0x0f];
+	}
+	hex[SHA256_HEX_LEN - 1] = '\0';
+}
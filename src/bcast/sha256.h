@@ -0,0 +1,54 @@
+/*****************************************************************************\
+ *  sha256.h - SHA-256 message digest
+ *****************************************************************************
+ *  Copyright (C) 2018 SchedMD LLC.
+ *
+ *  This file is part of Slurm, a resource management program.
+ *  For details, see <https://slurm.schedmd.com/>.
+ *  Please also read the included file: DISCLAIMER.
+ *
+ *  Slurm is free software; you can redistribute it and/or modify it under
+ *  the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  In addition, as a special exception, the copyright holders give permission
+ *  to link the code of portions of this program with the OpenSSL library under
+ *  certain conditions as described in each individual source file, and
+ *  distribute linked combinations including the two. You must obey the GNU
+ *  General Public License in all respects for all of the code used other than
+ *  OpenSSL. If you modify file(s) with this exception, you may extend this
+ *  exception to your version of the file(s), but you are not obligated to do
+ *  so. If you do not wish to do so, delete this exception statement from your
+ *  version.  If you delete this exception statement from all source files in
+ *  the program, then also delete it here.
+ *
+ *  Slurm is distributed in the hope that it will be useful, but WITHOUT ANY
+ *  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *  FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ *  details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with Slurm; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA.
+\*****************************************************************************/
+
+#ifndef _BCAST_SHA256_H
+#define _BCAST_SHA256_H
+
+#include <inttypes.h>
+#include <stddef.h>
+
+#define SHA256_DIGEST_LEN	32
+#define SHA256_HEX_LEN		(SHA256_DIGEST_LEN * 2 + 1)
+
+/*
+ * Compute the SHA-256 digest of a buffer
+ * IN data - buffer to digest
+ * IN len - length of data in bytes
+ * OUT hex - digest as a NUL terminated string of lower case hex digits,
+ *	     must have room for SHA256_HEX_LEN bytes
+ */
+extern void sha256_hex(const void *data, size_t len, char *hex);
+
+#endif
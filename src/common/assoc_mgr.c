@@ -79,6 +79,23 @@ static int *assoc_mgr_tres_old_pos = NULL;
 static pthread_mutex_t locks_mutex = PTHREAD_MUTEX_INITIALIZER;
 static pthread_cond_t locks_cond = PTHREAD_COND_INITIALIZER;
 
+/*
+ * Copy of the share information of every association, published by the
+ * priority plugin after each decay pass.  assoc_mgr_get_shares() serves
+ * requests from it without holding the assoc_mgr locks.  Readers hold a
+ * reference while they copy out of it, so a newer snapshot can be
+ * published at any time.
+ */
+typedef struct {
+	int ref_cnt;
+	List shares;		/* list of assoc_shares_object_t *'s */
+	uint32_t tres_cnt;
+	char **tres_names;	/* tres_cnt names matching the shares */
+} shares_snapshot_t;
+
+static shares_snapshot_t *shares_snapshot = NULL;
+static pthread_mutex_t shares_snapshot_lock = PTHREAD_MUTEX_INITIALIZER;
+
 static bool _running_cache(void)
 {
 	if (init_setup.running_cache && *init_setup.running_cache)
@@ -87,6 +104,51 @@ static bool _running_cache(void)
 	return false;
 }
 
+static char **_copy_tres_names(char **tres_names, uint32_t tres_cnt)
+{
+	char **names;
+	int i;
+
+	if (!tres_names || !tres_cnt)
+		return NULL;
+
+	names = xmalloc(sizeof(char *) * tres_cnt);
+	for (i = 0; i < tres_cnt; i++)
+		names[i] = xstrdup(tres_names[i]);
+
+	return names;
+}
+
+/* Must hold shares_snapshot_lock */
+static void _release_shares_snapshot(shares_snapshot_t *snapshot)
+{
+	int i;
+
+	if (!snapshot || --snapshot->ref_cnt)
+		return;
+
+	FREE_NULL_LIST(snapshot->shares);
+	if (snapshot->tres_names) {
+		for (i = 0; i < snapshot->tres_cnt; i++)
+			xfree(snapshot->tres_names[i]);
+		xfree(snapshot->tres_names);
+	}
+	xfree(snapshot);
+}
+
+/*
+ * Drop the published snapshot so it can't be used after the association
+ * or TRES lists change.  Requests fall back to the live lists until the
+ * next decay pass publishes a new one.
+ */
+static void _clear_shares_snapshot(void)
+{
+	slurm_mutex_lock(&shares_snapshot_lock);
+	_release_shares_snapshot(shares_snapshot);
+	shares_snapshot = NULL;
+	slurm_mutex_unlock(&shares_snapshot_lock);
+}
+
 static int _get_str_inx(char *name)
 {
 	int j, index = 0;
@@ -927,6 +989,8 @@ static int _post_assoc_list(void)
 	if (!assoc_mgr_assoc_list)
 		return SLURM_ERROR;
 
+	_clear_shares_snapshot();
+
 	xfree(assoc_hash_id);
 	xfree(assoc_hash);
 
@@ -1138,6 +1202,8 @@ extern int assoc_mgr_post_tres_list(List new_list)
 
 	xassert(new_list);
 
+	_clear_shares_snapshot();
+
 	new_cnt = list_count(new_list);
 
 	xassert(new_cnt > 0);
@@ -1662,13 +1728,12 @@ static int _refresh_assoc_mgr_tres_list(void *db_conn, int enforce)
 static int _refresh_assoc_mgr_assoc_list(void *db_conn, int enforce)
 {
 	slurmdb_assoc_cond_t assoc_q;
-	List current_assocs = NULL;
+	List current_assocs = NULL, new_assocs = NULL;
 	uid_t uid = getuid();
 	ListIterator curr_itr = NULL;
 	slurmdb_assoc_rec_t *curr_assoc = NULL, *assoc = NULL;
 	assoc_mgr_lock_t locks = { .assoc = WRITE_LOCK, .qos = READ_LOCK,
 				   .tres = READ_LOCK, .user = WRITE_LOCK };
-//	DEF_TIMERS;
 
 	memset(&assoc_q, 0, sizeof(slurmdb_assoc_cond_t));
 	if (assoc_mgr_cluster_name) {
@@ -1680,26 +1745,26 @@ static int _refresh_assoc_mgr_assoc_list(void *db_conn, int enforce)
 		      "all associations.");
 	}
 
-	assoc_mgr_lock(&locks);
-
-	current_assocs = assoc_mgr_assoc_list;
-
-//	START_TIMER;
-	assoc_mgr_assoc_list =
-		acct_storage_g_get_assocs(db_conn, uid, &assoc_q);
-//	END_TIMER2("get_assocs");
+	/*
+	 * Get the new list before locking, like the other refresh functions,
+	 * so the association locks aren't held while a large list comes
+	 * over the network.
+	 */
+	new_assocs = acct_storage_g_get_assocs(db_conn, uid, &assoc_q);
 
 	FREE_NULL_LIST(assoc_q.cluster_list);
 
-	if (!assoc_mgr_assoc_list) {
-		assoc_mgr_assoc_list = current_assocs;
-		assoc_mgr_unlock(&locks);
-
+	if (!new_assocs) {
 		error("_refresh_assoc_mgr_assoc_list: "
 		      "no new list given back keeping cached one.");
 		return SLURM_ERROR;
 	}
 
+	assoc_mgr_lock(&locks);
+
+	current_assocs = assoc_mgr_assoc_list;
+	assoc_mgr_assoc_list = new_assocs;
+
 	_post_assoc_list();
 
 	if (!current_assocs) {
@@ -2077,6 +2142,8 @@ extern int assoc_mgr_fini(bool save_state)
 
 	assoc_mgr_lock(&locks);
 
+	_clear_shares_snapshot();
+
 	FREE_NULL_LIST(assoc_mgr_assoc_list);
 	FREE_NULL_LIST(assoc_mgr_tres_list);
 	FREE_NULL_LIST(assoc_mgr_res_list);
@@ -3002,6 +3069,199 @@ extern bool assoc_mgr_is_user_acct_coord(void *db_conn,
 	return false;
 }
 
+/*
+ * Return true if the share of the association owned by user_name (NULL
+ * for an account association) in account acct should be given to the
+ * requester.
+ */
+static bool _shares_wanted(char *user_name, char *acct,
+			   ListIterator user_itr, ListIterator acct_itr,
+			   uint16_t private_data, int is_admin,
+			   slurmdb_user_rec_t *user)
+{
+	char *tmp_char = NULL;
+	ListIterator itr = NULL;
+	slurmdb_coord_rec_t *coord = NULL;
+
+	if (user_itr && user_name) {
+		while ((tmp_char = list_next(user_itr))) {
+			if (!xstrcasecmp(tmp_char, user_name))
+				break;
+		}
+		list_iterator_reset(user_itr);
+		/* not correct user */
+		if (!tmp_char)
+			return false;
+	}
+
+	if (acct_itr) {
+		while ((tmp_char = list_next(acct_itr))) {
+			if (!xstrcasecmp(tmp_char, acct))
+				break;
+		}
+		list_iterator_reset(acct_itr);
+		/* not correct account */
+		if (!tmp_char)
+			return false;
+	}
+
+	if (!(private_data & PRIVATE_DATA_USAGE) || is_admin)
+		return true;
+
+	if (user_name && !xstrcmp(user_name, user->name))
+		return true;
+
+	if (!user->coord_accts) {
+		debug4("This user isn't a coord.");
+		return false;
+	}
+
+	if (!acct) {
+		debug("No account name given in association.");
+		return false;
+	}
+
+	itr = list_iterator_create(user->coord_accts);
+	while ((coord = list_next(itr))) {
+		if (!xstrcasecmp(coord->name, acct))
+			break;
+	}
+	list_iterator_destroy(itr);
+
+	return coord ? true : false;
+}
+
+/* Must hold assoc_mgr assoc and tres read locks */
+static assoc_shares_object_t *_make_shares_object(slurmdb_assoc_rec_t *assoc)
+{
+	assoc_shares_object_t *share = xmalloc(sizeof(assoc_shares_object_t));
+
+	share->assoc_id = assoc->id;
+	share->cluster = xstrdup(assoc->cluster);
+
+	if (assoc == assoc_mgr_root_assoc)
+		share->shares_raw = NO_VAL;
+	else
+		share->shares_raw = assoc->shares_raw;
+
+	share->shares_norm = assoc->usage->shares_norm;
+	share->usage_raw = (uint64_t)assoc->usage->usage_raw;
+
+	share->usage_tres_raw = xmalloc(
+		sizeof(long double) * g_tres_count);
+	memcpy(share->usage_tres_raw,
+	       assoc->usage->usage_tres_raw,
+	       sizeof(long double) * g_tres_count);
+
+	share->tres_grp_mins = xmalloc(sizeof(uint64_t) * g_tres_count);
+	memcpy(share->tres_grp_mins, assoc->grp_tres_mins_ctld,
+	       sizeof(uint64_t) * g_tres_count);
+	share->tres_run_secs = xmalloc(sizeof(uint64_t) * g_tres_count);
+	memcpy(share->tres_run_secs,
+	       assoc->usage->grp_used_tres_run_secs,
+	       sizeof(uint64_t) * g_tres_count);
+	share->fs_factor = assoc->usage->fs_factor;
+	share->level_fs = assoc->usage->level_fs;
+
+	if (assoc->partition) {
+		share->partition =  xstrdup(assoc->partition);
+	} else {
+		share->partition = NULL;
+	}
+
+	if (assoc->user) {
+		/* We only calculate user effective usage when
+		 * we need it
+		 */
+		if (fuzzy_equal(assoc->usage->usage_efctv, NO_VAL))
+			priority_g_set_assoc_usage(assoc);
+
+		share->name = xstrdup(assoc->user);
+		share->parent = xstrdup(assoc->acct);
+		share->user = 1;
+	} else {
+		share->name = xstrdup(assoc->acct);
+		if (!assoc->parent_acct
+		    && assoc->usage->parent_assoc_ptr)
+			share->parent = xstrdup(
+				assoc->usage->parent_assoc_ptr->acct);
+		else
+			share->parent = xstrdup(assoc->parent_acct);
+	}
+	share->usage_norm = (double)assoc->usage->usage_norm;
+	share->usage_efctv = (double)assoc->usage->usage_efctv;
+
+	return share;
+}
+
+static assoc_shares_object_t *_copy_shares_object(
+	assoc_shares_object_t *src, uint32_t tres_cnt)
+{
+	assoc_shares_object_t *share = xmalloc(sizeof(assoc_shares_object_t));
+
+	memcpy(share, src, sizeof(assoc_shares_object_t));
+	share->cluster = xstrdup(src->cluster);
+	share->name = xstrdup(src->name);
+	share->parent = xstrdup(src->parent);
+	share->partition = xstrdup(src->partition);
+
+	share->usage_tres_raw = xmalloc(sizeof(long double) * tres_cnt);
+	memcpy(share->usage_tres_raw, src->usage_tres_raw,
+	       sizeof(long double) * tres_cnt);
+	share->tres_grp_mins = xmalloc(sizeof(uint64_t) * tres_cnt);
+	memcpy(share->tres_grp_mins, src->tres_grp_mins,
+	       sizeof(uint64_t) * tres_cnt);
+	share->tres_run_secs = xmalloc(sizeof(uint64_t) * tres_cnt);
+	memcpy(share->tres_run_secs, src->tres_run_secs,
+	       sizeof(uint64_t) * tres_cnt);
+
+	return share;
+}
+
+extern void assoc_mgr_publish_shares(void)
+{
+	ListIterator itr = NULL;
+	slurmdb_assoc_rec_t *assoc = NULL;
+	shares_snapshot_t *snapshot;
+	int share_cnt;
+	assoc_mgr_lock_t locks = { .assoc = READ_LOCK, .tres = READ_LOCK };
+	DEF_TIMERS;
+
+	START_TIMER;
+	assoc_mgr_lock(&locks);
+	if (!assoc_mgr_assoc_list) {
+		assoc_mgr_unlock(&locks);
+		return;
+	}
+
+	snapshot = xmalloc(sizeof(shares_snapshot_t));
+	snapshot->ref_cnt = 1;
+	snapshot->shares = list_create(slurm_destroy_assoc_shares_object);
+	snapshot->tres_cnt = g_tres_count;
+	snapshot->tres_names = _copy_tres_names(assoc_mgr_tres_name_array,
+						g_tres_count);
+
+	itr = list_iterator_create(assoc_mgr_assoc_list);
+	while ((assoc = list_next(itr)))
+		list_append(snapshot->shares, _make_shares_object(assoc));
+	list_iterator_destroy(itr);
+	share_cnt = list_count(snapshot->shares);
+
+	/*
+	 * Swap while still holding the assoc read lock so a list change
+	 * (which clears the snapshot under the write lock) can't be
+	 * overwritten by a snapshot of the old list.
+	 */
+	slurm_mutex_lock(&shares_snapshot_lock);
+	_release_shares_snapshot(shares_snapshot);
+	shares_snapshot = snapshot;
+	slurm_mutex_unlock(&shares_snapshot_lock);
+
+	assoc_mgr_unlock(&locks);
+	END_TIMER2("assoc_mgr_publish_shares");
+	debug2("%s: published %d shares %s", __func__, share_cnt, TIME_STR);
+}
+
 extern void assoc_mgr_get_shares(void *db_conn,
 				 uid_t uid, shares_request_msg_t *req_msg,
 				 shares_response_msg_t *resp_msg)
@@ -3011,8 +3271,8 @@ extern void assoc_mgr_get_shares(void *db_conn,
 	ListIterator acct_itr = NULL;
 	slurmdb_assoc_rec_t *assoc = NULL;
 	assoc_shares_object_t *share = NULL;
+	shares_snapshot_t *snapshot = NULL;
 	List ret_list = NULL;
-	char *tmp_char = NULL;
 	slurmdb_user_rec_t user;
 	int is_admin=1;
 	uint16_t private_data = slurm_get_private_data();
@@ -3057,133 +3317,53 @@ extern void assoc_mgr_get_shares(void *db_conn,
 	resp_msg->assoc_shares_list = ret_list =
 		list_create(slurm_destroy_assoc_shares_object);
 
-	assoc_mgr_lock(&locks);
-
-	resp_msg->tres_cnt = g_tres_count;
-
-	/* DON'T FREE, since this shouldn't change while the slurmctld
-	 * is running we should be ok.
-	*/
-	resp_msg->tres_names = assoc_mgr_tres_name_array;
-
-	itr = list_iterator_create(assoc_mgr_assoc_list);
-	while ((assoc = list_next(itr))) {
-		if (user_itr && assoc->user) {
-			while ((tmp_char = list_next(user_itr))) {
-				if (!xstrcasecmp(tmp_char, assoc->user))
-					break;
-			}
-			list_iterator_reset(user_itr);
-			/* not correct user */
-			if (!tmp_char)
-				continue;
-		}
-
-		if (acct_itr) {
-			while ((tmp_char = list_next(acct_itr))) {
-				if (!xstrcasecmp(tmp_char, assoc->acct))
-					break;
-			}
-			list_iterator_reset(acct_itr);
-			/* not correct account */
-			if (!tmp_char)
+	slurm_mutex_lock(&shares_snapshot_lock);
+	if ((snapshot = shares_snapshot))
+		snapshot->ref_cnt++;
+	slurm_mutex_unlock(&shares_snapshot_lock);
+
+	if (snapshot) {
+		resp_msg->tres_cnt = snapshot->tres_cnt;
+		resp_msg->tres_names = _copy_tres_names(snapshot->tres_names,
+							snapshot->tres_cnt);
+
+		itr = list_iterator_create(snapshot->shares);
+		while ((share = list_next(itr))) {
+			if (!_shares_wanted(share->user ? share->name : NULL,
+					    share->user ?
+					    share->parent : share->name,
+					    user_itr, acct_itr, private_data,
+					    is_admin, &user))
 				continue;
+			list_append(ret_list,
+				    _copy_shares_object(share,
+							snapshot->tres_cnt));
 		}
+		list_iterator_destroy(itr);
 
-		if (private_data & PRIVATE_DATA_USAGE) {
-			if (!is_admin) {
-				ListIterator itr = NULL;
-				slurmdb_coord_rec_t *coord = NULL;
-
-				if (assoc->user &&
-				    !xstrcmp(assoc->user, user.name))
-					goto is_user;
-
-				if (!user.coord_accts) {
-					debug4("This user isn't a coord.");
-					goto bad_user;
-				}
-
-				if (!assoc->acct) {
-					debug("No account name given "
-					      "in association.");
-					goto bad_user;
-				}
-
-				itr = list_iterator_create(user.coord_accts);
-				while ((coord = list_next(itr))) {
-					if (!xstrcasecmp(coord->name,
-							 assoc->acct))
-						break;
-				}
-				list_iterator_destroy(itr);
-
-				if (coord)
-					goto is_user;
-
-			bad_user:
-				continue;
-			}
-		}
-	is_user:
-
-		share = xmalloc(sizeof(assoc_shares_object_t));
-		list_append(ret_list, share);
-
-		share->assoc_id = assoc->id;
-		share->cluster = xstrdup(assoc->cluster);
+		slurm_mutex_lock(&shares_snapshot_lock);
+		_release_shares_snapshot(snapshot);
+		slurm_mutex_unlock(&shares_snapshot_lock);
+		goto end_it;
+	}
 
-		if (assoc == assoc_mgr_root_assoc)
-			share->shares_raw = NO_VAL;
-		else
-			share->shares_raw = assoc->shares_raw;
-
-		share->shares_norm = assoc->usage->shares_norm;
-		share->usage_raw = (uint64_t)assoc->usage->usage_raw;
-
-		share->usage_tres_raw = xmalloc(
-			sizeof(long double) * g_tres_count);
-		memcpy(share->usage_tres_raw,
-		       assoc->usage->usage_tres_raw,
-		       sizeof(long double) * g_tres_count);
-
-		share->tres_grp_mins = xmalloc(sizeof(uint64_t) * g_tres_count);
-		memcpy(share->tres_grp_mins, assoc->grp_tres_mins_ctld,
-		       sizeof(uint64_t) * g_tres_count);
-		share->tres_run_secs = xmalloc(sizeof(uint64_t) * g_tres_count);
-		memcpy(share->tres_run_secs,
-		       assoc->usage->grp_used_tres_run_secs,
-		       sizeof(uint64_t) * g_tres_count);
-		share->fs_factor = assoc->usage->fs_factor;
-		share->level_fs = assoc->usage->level_fs;
-
-		if (assoc->partition) {
-			share->partition =  xstrdup(assoc->partition);
-		} else {
-			share->partition = NULL;
-		}
+	assoc_mgr_lock(&locks);
 
-		if (assoc->user) {
-			/* We only calculate user effective usage when
-			 * we need it
-			 */
-			if (fuzzy_equal(assoc->usage->usage_efctv, NO_VAL))
-				priority_g_set_assoc_usage(assoc);
+	/*
+	 * The TRES names can change once the lock is released, the caller
+	 * must free this copy.
+	 */
+	resp_msg->tres_cnt = g_tres_count;
+	resp_msg->tres_names = _copy_tres_names(assoc_mgr_tres_name_array,
+						g_tres_count);
 
-			share->name = xstrdup(assoc->user);
-			share->parent = xstrdup(assoc->acct);
-			share->user = 1;
-		} else {
-			share->name = xstrdup(assoc->acct);
-			if (!assoc->parent_acct
-			    && assoc->usage->parent_assoc_ptr)
-				share->parent = xstrdup(
-					assoc->usage->parent_assoc_ptr->acct);
-			else
-				share->parent = xstrdup(assoc->parent_acct);
-		}
-		share->usage_norm = (double)assoc->usage->usage_norm;
-		share->usage_efctv = (double)assoc->usage->usage_efctv;
+	itr = list_iterator_create(assoc_mgr_assoc_list);
+	while ((assoc = list_next(itr))) {
+		if (!_shares_wanted(assoc->user, assoc->acct,
+				    user_itr, acct_itr, private_data,
+				    is_admin, &user))
+			continue;
+		list_append(ret_list, _make_shares_object(assoc));
 	}
 	list_iterator_destroy(itr);
 	assoc_mgr_unlock(&locks);
@@ -3995,6 +4175,8 @@ extern int assoc_mgr_update_assocs(slurmdb_update_object_t *update, bool locked)
 		slurmdb_sort_hierarchical_assoc_list(
 			assoc_mgr_assoc_list, true);
 
+	_clear_shares_snapshot();
+
 	if (!locked)
 		assoc_mgr_unlock(&locks);
 
@@ -6030,9 +6212,28 @@ unpack_error:
 	return SLURM_ERROR;
 }
 
+/* Run one phase of assoc_mgr_refresh_lists() and note how long it took */
+static int _refresh_phase(void *db_conn, const char *name,
+			  int (*refresh_func)(void *db_conn, int enforce),
+			  char **phase_times)
+{
+	int rc;
+	DEF_TIMERS;
+
+	START_TIMER;
+	rc = (*refresh_func)(db_conn, init_setup.enforce);
+	END_TIMER2("assoc_mgr_refresh_lists");
+	xstrfmtcat(*phase_times, "%s%s=%s",
+		   *phase_times ? " " : "", name, TIME_STR);
+
+	return rc;
+}
+
 extern int assoc_mgr_refresh_lists(void *db_conn, uint16_t cache_level)
 {
 	bool partial_list = 1;
+	int rc = SLURM_SUCCESS;
+	char *phase_times = NULL;
 
 	if (!cache_level) {
 		cache_level = init_setup.cache_level;
@@ -6040,37 +6241,44 @@ extern int assoc_mgr_refresh_lists(void *db_conn, uint16_t cache_level)
 	}
 
 	/* get tres before association and qos since it is used there */
-	if (cache_level & ASSOC_MGR_CACHE_TRES) {
-		if (_refresh_assoc_mgr_tres_list(
-			    db_conn, init_setup.enforce) == SLURM_ERROR)
-			return SLURM_ERROR;
-	}
+	if ((cache_level & ASSOC_MGR_CACHE_TRES) &&
+	    (_refresh_phase(db_conn, "tres", _refresh_assoc_mgr_tres_list,
+			    &phase_times) == SLURM_ERROR))
+		rc = SLURM_ERROR;
 
 	/* get qos before association since it is used there */
-	if (cache_level & ASSOC_MGR_CACHE_QOS)
-		if (_refresh_assoc_mgr_qos_list(
-			    db_conn, init_setup.enforce) == SLURM_ERROR)
-			return SLURM_ERROR;
+	if ((rc == SLURM_SUCCESS) && (cache_level & ASSOC_MGR_CACHE_QOS) &&
+	    (_refresh_phase(db_conn, "qos", _refresh_assoc_mgr_qos_list,
+			    &phase_times) == SLURM_ERROR))
+		rc = SLURM_ERROR;
 
 	/* get user before association/wckey since it is used there */
-	if (cache_level & ASSOC_MGR_CACHE_USER)
-		if (_refresh_assoc_mgr_user_list(
-			    db_conn, init_setup.enforce) == SLURM_ERROR)
-			return SLURM_ERROR;
-
-	if (cache_level & ASSOC_MGR_CACHE_ASSOC) {
-		if (_refresh_assoc_mgr_assoc_list(
-			    db_conn, init_setup.enforce) == SLURM_ERROR)
-			return SLURM_ERROR;
-	}
-	if (cache_level & ASSOC_MGR_CACHE_WCKEY)
-		if (_refresh_assoc_wckey_list(
-			    db_conn, init_setup.enforce) == SLURM_ERROR)
-			return SLURM_ERROR;
-	if (cache_level & ASSOC_MGR_CACHE_RES)
-		if (_refresh_assoc_mgr_res_list(
-			    db_conn, init_setup.enforce) == SLURM_ERROR)
-			return SLURM_ERROR;
+	if ((rc == SLURM_SUCCESS) && (cache_level & ASSOC_MGR_CACHE_USER) &&
+	    (_refresh_phase(db_conn, "user", _refresh_assoc_mgr_user_list,
+			    &phase_times) == SLURM_ERROR))
+		rc = SLURM_ERROR;
+
+	if ((rc == SLURM_SUCCESS) && (cache_level & ASSOC_MGR_CACHE_ASSOC) &&
+	    (_refresh_phase(db_conn, "assoc", _refresh_assoc_mgr_assoc_list,
+			    &phase_times) == SLURM_ERROR))
+		rc = SLURM_ERROR;
+
+	if ((rc == SLURM_SUCCESS) && (cache_level & ASSOC_MGR_CACHE_WCKEY) &&
+	    (_refresh_phase(db_conn, "wckey", _refresh_assoc_wckey_list,
+			    &phase_times) == SLURM_ERROR))
+		rc = SLURM_ERROR;
+
+	if ((rc == SLURM_SUCCESS) && (cache_level & ASSOC_MGR_CACHE_RES) &&
+	    (_refresh_phase(db_conn, "res", _refresh_assoc_mgr_res_list,
+			    &phase_times) == SLURM_ERROR))
+		rc = SLURM_ERROR;
+
+	if (phase_times)
+		debug("%s: %s", __func__, phase_times);
+	xfree(phase_times);
+
+	if (rc != SLURM_SUCCESS)
+		return rc;
 
 	if (!partial_list && _running_cache())
 		*init_setup.running_cache = 0;
@@ -267,6 +267,13 @@ extern slurmdb_admin_level_t assoc_mgr_get_admin_level(void *db_conn,
 extern bool assoc_mgr_is_user_acct_coord(void *db_conn, uint32_t uid,
 					char *acct);
 
+/*
+ * Publish a copy of the share information of every association for
+ * assoc_mgr_get_shares() to serve requests from without taking the
+ * assoc_mgr locks.  Called by the priority plugin after each decay pass.
+ */
+extern void assoc_mgr_publish_shares(void);
+
 /*
  * get the share information from the association list
  * IN: uid: uid_t of user issuing the request
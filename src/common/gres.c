@@ -3818,7 +3818,7 @@ static void	_job_core_filter(void *job_gres_data, void *node_gres_data,
 				 int core_start_bit, int core_end_bit,
 				 char *gres_name, char *node_name)
 {
-	int i, j, core_ctld;
+	int i, j, core_ctld, core_size;
 	gres_job_state_t  *job_gres_ptr  = (gres_job_state_t *)  job_gres_data;
 	gres_node_state_t *node_gres_ptr = (gres_node_state_t *) node_gres_data;
 	bitstr_t *avail_core_bitmap = NULL;
@@ -3827,9 +3827,15 @@ static void	_job_core_filter(void *job_gres_data, void *node_gres_data,
 	    !job_gres_ptr->gres_per_node)		/* No job GRES */
 		return;
 
-	/* Determine which specific cores can be used */
-	avail_core_bitmap = bit_copy(core_bitmap);
-	bit_nclear(avail_core_bitmap, core_start_bit, core_end_bit);
+	/*
+	 * Determine which specific cores can be used. core_bitmap spans
+	 * every node, so build the mask for this node's cores only rather
+	 * than copying and ANDing the whole bitmap for each node.
+	 */
+	core_ctld = core_end_bit - core_start_bit + 1;
+	if (core_ctld < 1)
+		return;
+	avail_core_bitmap = bit_alloc(core_ctld);
 	for (i = 0; i < node_gres_ptr->topo_cnt; i++) {
 		if (node_gres_ptr->topo_gres_cnt_avail[i] == 0)
 			continue;
@@ -3846,16 +3852,23 @@ static void	_job_core_filter(void *job_gres_data, void *node_gres_data,
 			FREE_NULL_BITMAP(avail_core_bitmap);	/* No filter */
 			return;
 		}
-		core_ctld = core_end_bit - core_start_bit + 1;
 		_validate_gres_node_cores(node_gres_ptr, core_ctld, node_name);
-		core_ctld = bit_size(node_gres_ptr->topo_core_bitmap[i]);
-		for (j = 0; j < core_ctld; j++) {
-			if (bit_test(node_gres_ptr->topo_core_bitmap[i], j)) {
-				bit_set(avail_core_bitmap, core_start_bit + j);
-			}
+		core_size = bit_size(node_gres_ptr->topo_core_bitmap[i]);
+		if (core_size == core_ctld) {
+			bit_or(avail_core_bitmap,
+			       node_gres_ptr->topo_core_bitmap[i]);
+			continue;
 		}
+		core_size = MIN(core_size, core_ctld);
+		for (j = 0; j < core_size; j++) {
+			if (bit_test(node_gres_ptr->topo_core_bitmap[i], j))
+				bit_set(avail_core_bitmap, j);
+		}
+	}
+	for (j = 0; j < core_ctld; j++) {
+		if (!bit_test(avail_core_bitmap, j))
+			bit_clear(core_bitmap, core_start_bit + j);
 	}
-	bit_and(core_bitmap, avail_core_bitmap);
 	FREE_NULL_BITMAP(avail_core_bitmap);
 }
 
@@ -419,6 +419,8 @@ static slurm_errtab_t slurm_errtab[] = {
 	  "Job step is suspended"                               },
  	{ ESLURMD_STEP_NOTSUSPENDED,
 	  "Job step is not currently suspended"                 },
+ 	{ ESLURMD_BCAST_CACHE_MISS,
+	  "File block not found in sbcast cache"                },
 
 	/* slurmd errors in user batch job */
 	{ ESCRIPT_CHDIR_FAILED,
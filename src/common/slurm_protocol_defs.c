@@ -3977,6 +3977,7 @@ extern void slurm_free_file_bcast_msg(file_bcast_msg_t *msg)
 {
 	if (msg) {
 		xfree(msg->block);
+		xfree(msg->block_hash);
 		xfree(msg->fname);
 		xfree(msg->user_name);
 		delete_sbcast_cred(msg->cred);
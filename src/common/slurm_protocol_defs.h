@@ -1162,6 +1162,8 @@ typedef struct file_bcast_msg {
 	uint64_t block_offset;	/* offset for this data block */
 	uint32_t uncomp_len;	/* uncompressed length of this data block */
 	char *block;		/* data for this block */
+	char *block_hash;	/* SHA-256 of uncompressed block data */
+	uint16_t cache_probe;	/* no data sent, use cached block if set */
 	uint64_t file_size;	/* file size */
 } file_bcast_msg_t;
 
@@ -56,6 +56,7 @@
 #include "src/common/xmalloc.h"
 #include "src/common/xstring.h"
 
+strong_alias(route_g_split_hostlist, slurm_route_g_split_hostlist);
 strong_alias(route_split_hostlist_treewidth,
 	     slurm_route_split_hostlist_treewidth);
 
@@ -51,6 +51,7 @@
 struct switch_record *switch_record_table = NULL;
 int switch_record_cnt = 0;
 int switch_levels = 0;               /* number of switch levels     */
+bool switch_tree_strict = false;
 
 /* defined here but is really hypercube plugin related */
 int hypercube_dimensions = 0; 
@@ -167,3 +168,74 @@ extern int slurm_topo_get_node_addr(char* node_name,
 
 	return (*(ops.get_node_addr))(node_name,addr,pattern);
 }
+
+/*
+ * Build the list of node indexes below leaf switch sw, so a leaf's available
+ * nodes can be found without scanning a bitmap sized for the whole cluster.
+ */
+extern void switch_leaf_index_build(int sw)
+{
+	struct switch_record *switch_ptr = &switch_record_table[sw];
+	int i, first, last;
+
+	xfree(switch_ptr->node_index);
+	switch_ptr->node_cnt = 0;
+	first = bit_ffs(switch_ptr->node_bitmap);
+	if (first < 0)
+		return;
+	last = bit_fls(switch_ptr->node_bitmap);
+	switch_ptr->node_index = xmalloc(sizeof(int) *
+					 bit_set_count(switch_ptr->node_bitmap));
+	for (i = first; i <= last; i++) {
+		if (bit_test(switch_ptr->node_bitmap, i))
+			switch_ptr->node_index[switch_ptr->node_cnt++] = i;
+	}
+}
+
+/*
+ * Add the available node and CPU counts of every leaf switch to the leaf and
+ * its ancestors, rather than intersecting every switch's bitmap with the
+ * available nodes. Valid only if switch_tree_strict is set.
+ */
+extern void switch_leaf_counts(bitstr_t *node_map, uint16_t *cpu_cnt,
+			       int *switches_cpu_cnt, int *switches_node_cnt,
+			       bitstr_t *avail_nodes_bitmap)
+{
+	struct switch_record *switch_ptr = switch_record_table;
+	int i, j, n, node_cnt, cpus;
+
+	for (i = 0; i < switch_record_cnt; i++, switch_ptr++) {
+		if (switch_ptr->level != 0)
+			continue;
+		node_cnt = cpus = 0;
+		for (j = 0; j < switch_ptr->node_cnt; j++) {
+			n = switch_ptr->node_index[j];
+			if (!bit_test(node_map, n))
+				continue;
+			bit_set(avail_nodes_bitmap, n);
+			node_cnt++;
+			cpus += cpu_cnt[n];
+		}
+		if (node_cnt == 0)
+			continue;
+		for (j = i; j != NO_VAL16; j = switch_record_table[j].parent) {
+			switches_node_cnt[j] += node_cnt;
+			switches_cpu_cnt[j]  += cpus;
+		}
+	}
+}
+
+/*
+ * Return true if leaf switch leaf_inx is switch sw_inx or below it.
+ * Valid only if switch_tree_strict is set.
+ */
+extern bool switch_leaf_below(int leaf_inx, int sw_inx)
+{
+	int j;
+
+	for (j = leaf_inx; j != NO_VAL16; j = switch_record_table[j].parent) {
+		if (j == sw_inx)
+			return true;
+	}
+	return false;
+}
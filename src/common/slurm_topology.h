@@ -55,8 +55,12 @@ struct switch_record {
 	bitstr_t *node_bitmap;		/* bitmap of all nodes descended from
 					 * this switch */
 	char *nodes;			/* name if direct descendant nodes */
+	int node_cnt;			/* leaf only: size of node_index */
+	int *node_index;		/* leaf only: node_record_table indexes
+					 * of direct descendant nodes */
 	uint16_t  num_switches;         /* number of descendant switches */
-	uint16_t  parent;		/* index of parent switch */
+	uint16_t  parent;		/* index of parent switch, NO_VAL16 if
+					 * none */
 	char *switches;			/* name of direct descendant switches */
 	uint16_t *switch_index;		/* indexes of child switches */
 	uint32_t temp;			/* temperature, in celsius */
@@ -65,6 +69,10 @@ struct switch_record {
 extern struct switch_record *switch_record_table;  /* ptr to switch records */
 extern int switch_record_cnt;		/* size of switch_record_table */
 extern int switch_levels;               /* number of switch levels     */
+extern bool switch_tree_strict;		/* every node on one leaf switch and
+					 * every switch below at most one
+					 * parent, so counts of a switch are
+					 * the sums of its children */
 
 /*****************************************************************************\
  *  Hypercube SWITCH topology data structures
@@ -137,4 +145,32 @@ extern bool slurm_topo_generate_node_ranking( void );
 extern int slurm_topo_get_node_addr( char* node_name, char** addr,
 				     char** pattern );
 
+/*****************************************************************************\
+ *  Leaf switch node lists, used when switch_tree_strict is set
+\*****************************************************************************/
+
+/*
+ * switch_leaf_index_build - set node_index and node_cnt of leaf switch sw
+ *	from its node_bitmap
+ */
+extern void switch_leaf_index_build(int sw);
+
+/*
+ * switch_leaf_counts - add the nodes of node_map below each leaf switch, and
+ *	their CPUs from cpu_cnt, to the counts of the leaf and its ancestors
+ * IN node_map - available nodes
+ * IN cpu_cnt - usable CPUs per node index
+ * IN/OUT switches_cpu_cnt, switches_node_cnt - per switch counts
+ * IN/OUT avail_nodes_bitmap - nodes of node_map on some leaf are set
+ */
+extern void switch_leaf_counts(bitstr_t *node_map, uint16_t *cpu_cnt,
+			       int *switches_cpu_cnt, int *switches_node_cnt,
+			       bitstr_t *avail_nodes_bitmap);
+
+/*
+ * switch_leaf_below - return true if leaf switch leaf_inx is switch sw_inx
+ *	or below it
+ */
+extern bool switch_leaf_below(int leaf_inx, int sw_inx);
+
 #endif /*__SLURM_CONTROLLER_TOPO_PLUGIN_API_H__*/
@@ -416,6 +416,7 @@
 #define unpack_slurm_step_layout        slurm_unpack_slurm_step_layout
 
 /* slurm_step_route.[ch] functions */
+#define route_g_split_hostlist		slurm_route_g_split_hostlist
 #define route_split_hostlist_treewidth	slurm_route_split_hostlist_treewidth
 
 
@@ -1141,6 +1141,7 @@ extern void slurmdb_destroy_job_cond(void *object)
 		FREE_NULL_LIST(job_cond->cluster_list);
 		FREE_NULL_LIST(job_cond->groupid_list);
 		FREE_NULL_LIST(job_cond->jobname_list);
+		xfree(job_cond->page_cluster);
 		FREE_NULL_LIST(job_cond->partition_list);
 		FREE_NULL_LIST(job_cond->qos_list);
 		FREE_NULL_LIST(job_cond->resv_list);
@@ -4215,8 +4216,6 @@ extern void slurmdb_transfer_acct_list_2_tres(
 extern void slurmdb_transfer_tres_time(
 	List *tres_list_out, char *tres_str, int elapsed)
 {
-	ListIterator itr;
-	slurmdb_tres_rec_t *tres_rec = NULL;
 	List job_tres_list = NULL;
 
 	xassert(tres_list_out);
@@ -4224,17 +4223,29 @@ extern void slurmdb_transfer_tres_time(
 	slurmdb_tres_list_from_string(&job_tres_list, tres_str,
 				      TRES_STR_FLAG_NONE);
 
-	if (!job_tres_list)
+	slurmdb_transfer_tres_list_time(tres_list_out, job_tres_list, elapsed);
+	FREE_NULL_LIST(job_tres_list);
+}
+
+/* Same as slurmdb_transfer_tres_time() for an already parsed TRES list */
+extern void slurmdb_transfer_tres_list_time(
+	List *tres_list_out, List tres_list, int elapsed)
+{
+	ListIterator itr;
+	slurmdb_tres_rec_t *tres_rec = NULL;
+
+	xassert(tres_list_out);
+
+	if (!tres_list)
 		return;
 
 	/* get the amount of time this assoc used
 	   during the time we are looking at */
-	itr = list_iterator_create(job_tres_list);
+	itr = list_iterator_create(tres_list);
 	while ((tres_rec = list_next(itr)))
 		slurmdb_add_time_from_count_to_tres_list(
 			tres_rec, tres_list_out, elapsed);
 	list_iterator_destroy(itr);
-	FREE_NULL_LIST(job_tres_list);
 }
 
 extern int slurmdb_get_tres_base_unit(char *tres_type)
@@ -4292,6 +4303,11 @@ extern void slurmdb_destroy_stats_rec(void *object)
 		xfree(rpc_stats->rpc_user_id);
 		xfree(rpc_stats->rpc_user_cnt);
 		xfree(rpc_stats->rpc_user_time);
+
+		xfree(rpc_stats->lane_cnt);
+		xfree(rpc_stats->lane_time);
+		xfree(rpc_stats->lane_max_time);
+		xfree(rpc_stats->lane_wait_time);
 		xfree(object);
 	}
 }
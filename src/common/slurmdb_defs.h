@@ -282,6 +282,8 @@ extern void slurmdb_transfer_acct_list_2_tres(
 	List accounting_list, List *tres);
 extern void slurmdb_transfer_tres_time(
 	List *tres_list_out, char *tres_str, int elapsed);
+extern void slurmdb_transfer_tres_list_time(
+	List *tres_list_out, List tres_list, int elapsed);
 
 extern int slurmdb_get_tres_base_unit(char *tres_type);
 extern char *slurmdb_ave_tres_usage(char *tres_string, int tasks);
@@ -5149,6 +5149,9 @@ extern void slurmdb_pack_job_cond(void *in, uint16_t protocol_version,
 			pack32(NO_VAL, buffer);	/* count(jobname_list) */
 			pack32(0, buffer);	/* nodes_max */
 			pack32(0, buffer);	/* nodes_min */
+			packnull(buffer);	/* page_cluster */
+			pack32(0, buffer);	/* page_jobid */
+			pack32(0, buffer);	/* page_size */
 			pack32(NO_VAL, buffer);	/* count(partition_list) */
 			pack32(NO_VAL, buffer);	/* count(qos_list) */
 			pack32(NO_VAL, buffer);	/* count(resv_list) */
@@ -5246,6 +5249,9 @@ extern void slurmdb_pack_job_cond(void *in, uint16_t protocol_version,
 
 		pack32(object->nodes_max, buffer);
 		pack32(object->nodes_min, buffer);
+		packstr(object->page_cluster, buffer);
+		pack32(object->page_jobid, buffer);
+		pack32(object->page_size, buffer);
 
 		if (object->partition_list)
 			count = list_count(object->partition_list);
@@ -5932,6 +5938,10 @@ extern int slurmdb_unpack_job_cond(void **object, uint16_t protocol_version,
 
 		safe_unpack32(&object_ptr->nodes_max, buffer);
 		safe_unpack32(&object_ptr->nodes_min, buffer);
+		safe_unpackstr_xmalloc(&object_ptr->page_cluster, &uint32_tmp,
+				       buffer);
+		safe_unpack32(&object_ptr->page_jobid, buffer);
+		safe_unpack32(&object_ptr->page_size, buffer);
 
 		safe_unpack32(&count, buffer);
 		if (count > NO_VAL)
@@ -9217,7 +9227,42 @@ extern void slurmdb_pack_stats_msg(void *object, uint16_t protocol_version,
 	slurmdb_stats_rec_t *stats_ptr = (slurmdb_stats_rec_t *) object;
 	uint32_t i;
 
-	if (protocol_version >= SLURM_MIN_PROTOCOL_VERSION) {
+	if (protocol_version >= SLURM_18_08_PROTOCOL_VERSION) {
+		/* Rollup statistics */
+		i = 3;
+		pack32(i, buffer);
+		pack16_array(stats_ptr->rollup_count,    i, buffer);
+		pack64_array(stats_ptr->rollup_time,     i, buffer);
+		pack64_array(stats_ptr->rollup_max_time, i, buffer);
+
+		/* RPC type statistics */
+		for (i = 0; i < stats_ptr->type_cnt; i++) {
+			if (stats_ptr->rpc_type_id[i] == 0)
+				break;
+		}
+		pack32(i, buffer);
+		pack16_array(stats_ptr->rpc_type_id,   i, buffer);
+		pack32_array(stats_ptr->rpc_type_cnt,  i, buffer);
+		pack64_array(stats_ptr->rpc_type_time, i, buffer);
+
+		/* RPC user statistics */
+		for (i = 1; i < stats_ptr->user_cnt; i++) {
+			if (stats_ptr->rpc_user_id[i] == 0)
+				break;
+		}
+		pack32(i, buffer);
+		pack32_array(stats_ptr->rpc_user_id,   i, buffer);
+		pack32_array(stats_ptr->rpc_user_cnt,  i, buffer);
+		pack64_array(stats_ptr->rpc_user_time, i, buffer);
+
+		/* RPC lane statistics */
+		i = SLURMDB_LANE_COUNT;
+		pack32(i, buffer);
+		pack32_array(stats_ptr->lane_cnt,       i, buffer);
+		pack64_array(stats_ptr->lane_time,      i, buffer);
+		pack64_array(stats_ptr->lane_max_time,  i, buffer);
+		pack64_array(stats_ptr->lane_wait_time, i, buffer);
+	} else if (protocol_version >= SLURM_MIN_PROTOCOL_VERSION) {
 		/* Rollup statistics */
 		i = 3;
 		pack32(i, buffer);
@@ -9258,7 +9303,73 @@ extern int slurmdb_unpack_stats_msg(void **object, uint16_t protocol_version,
 		xmalloc(sizeof(slurmdb_stats_rec_t));
 
 	*object = stats_ptr;
-	if (protocol_version >= SLURM_MIN_PROTOCOL_VERSION) {
+	if (protocol_version >= SLURM_18_08_PROTOCOL_VERSION) {
+		/* Rollup statistics */
+		safe_unpack32(&uint32_tmp, buffer);
+		if (uint32_tmp != 3)
+			goto unpack_error;
+		safe_unpack16_array(&stats_ptr->rollup_count, &uint32_tmp,
+				    buffer);
+		if (uint32_tmp != 3)
+			goto unpack_error;
+		safe_unpack64_array(&stats_ptr->rollup_time, &uint32_tmp,
+				    buffer);
+		if (uint32_tmp != 3)
+			goto unpack_error;
+		safe_unpack64_array(&stats_ptr->rollup_max_time, &uint32_tmp,
+				    buffer);
+		if (uint32_tmp != 3)
+			goto unpack_error;
+
+		/* RPC type statistics */
+		safe_unpack32(&stats_ptr->type_cnt, buffer);
+		safe_unpack16_array(&stats_ptr->rpc_type_id, &uint32_tmp,
+				    buffer);
+		if (uint32_tmp != stats_ptr->type_cnt)
+			goto unpack_error;
+		safe_unpack32_array(&stats_ptr->rpc_type_cnt, &uint32_tmp,
+				    buffer);
+		if (uint32_tmp != stats_ptr->type_cnt)
+			goto unpack_error;
+		safe_unpack64_array(&stats_ptr->rpc_type_time, &uint32_tmp,
+				    buffer);
+		if (uint32_tmp != stats_ptr->type_cnt)
+			goto unpack_error;
+
+		/* RPC user statistics */
+		safe_unpack32(&stats_ptr->user_cnt, buffer);
+		safe_unpack32_array(&stats_ptr->rpc_user_id, &uint32_tmp,
+				    buffer);
+		if (uint32_tmp != stats_ptr->user_cnt)
+			goto unpack_error;
+		safe_unpack32_array(&stats_ptr->rpc_user_cnt, &uint32_tmp,
+				    buffer);
+		if (uint32_tmp != stats_ptr->user_cnt)
+			goto unpack_error;
+		safe_unpack64_array(&stats_ptr->rpc_user_time, &uint32_tmp,
+				    buffer);
+		if (uint32_tmp != stats_ptr->user_cnt)
+			goto unpack_error;
+
+		/* RPC lane statistics */
+		safe_unpack32(&uint32_tmp, buffer);
+		if (uint32_tmp != SLURMDB_LANE_COUNT)
+			goto unpack_error;
+		safe_unpack32_array(&stats_ptr->lane_cnt, &uint32_tmp, buffer);
+		if (uint32_tmp != SLURMDB_LANE_COUNT)
+			goto unpack_error;
+		safe_unpack64_array(&stats_ptr->lane_time, &uint32_tmp, buffer);
+		if (uint32_tmp != SLURMDB_LANE_COUNT)
+			goto unpack_error;
+		safe_unpack64_array(&stats_ptr->lane_max_time, &uint32_tmp,
+				    buffer);
+		if (uint32_tmp != SLURMDB_LANE_COUNT)
+			goto unpack_error;
+		safe_unpack64_array(&stats_ptr->lane_wait_time, &uint32_tmp,
+				    buffer);
+		if (uint32_tmp != SLURMDB_LANE_COUNT)
+			goto unpack_error;
+	} else if (protocol_version >= SLURM_MIN_PROTOCOL_VERSION) {
 		/* Rollup statistics */
 		safe_unpack32(&uint32_tmp, buffer);
 		if (uint32_tmp != 3)
@@ -48,6 +48,9 @@
 #include "src/common/slurm_protocol_api.h"
 #include "src/common/read_config.h"
 
+/* Log the prepared statement statistics of a connection hourly */
+#define STMT_LOG_INTERVAL 3600
+
 static char *table_defs_table = "table_defs_table";
 
 typedef struct {
@@ -131,6 +134,42 @@ static MYSQL_RES *_get_last_result(MYSQL *db_conn)
 	return last_result;
 }
 
+/*
+ * Log a failed statement, errors that can not be recovered from are fatal
+ * IN func - API call that failed
+ * IN err, err_str - MySQL error number and message
+ * IN query - statement that failed
+ * RET SLURM_SUCCESS if the error is expected and harmless, else SLURM_ERROR
+ */
+static int _handle_query_error(const char *func, unsigned int err,
+			       const char *err_str, char *query)
+{
+	if (err == ER_NO_SUCH_TABLE) {
+		debug4("This could happen often and is expected.\n"
+		       "%s failed: %u %s\n%s", func, err, err_str, query);
+		return SLURM_SUCCESS;
+	}
+	error("%s failed: %u %s\n%s", func, err, err_str, query);
+	if (err == ER_LOCK_WAIT_TIMEOUT) {
+		/* FIXME: If we get ER_LOCK_WAIT_TIMEOUT here we need
+		 * to restart the connections, but it appears restarting
+		 * the calling program is the only way to handle this.
+		 * If anyone in the future figures out a way to handle
+		 * this, super.  Until then we will need to restart the
+		 * calling program if you ever get this error.
+		 */
+		fatal("mysql gave ER_LOCK_WAIT_TIMEOUT as an error. "
+		      "The only way to fix this is restart the "
+		      "calling program");
+	} else if (err == ER_HOST_IS_BLOCKED) {
+		fatal("MySQL gave ER_HOST_IS_BLOCKED as an error. "
+		      "You will need to call 'mysqladmin flush-hosts' "
+		      "to regain connectivity.");
+	}
+
+	return SLURM_ERROR;
+}
+
 /* NOTE: Ensure that mysql_conn->lock is set on function entry */
 static int _mysql_query_internal(MYSQL *db_conn, char *query)
 {
@@ -142,35 +181,11 @@ static int _mysql_query_internal(MYSQL *db_conn, char *query)
 	/* clear out the old results so we don't get a 2014 error */
 	_clear_results(db_conn);
 	if (mysql_query(db_conn, query)) {
-		const char *err_str = mysql_error(db_conn);
 		errno = mysql_errno(db_conn);
-		if (errno == ER_NO_SUCH_TABLE) {
-			debug4("This could happen often and is expected.\n"
-			       "mysql_query failed: %d %s\n%s",
-			       errno, err_str, query);
-			errno = 0;
-			goto end_it;
-		}
-		error("mysql_query failed: %d %s\n%s", errno, err_str, query);
-		if (errno == ER_LOCK_WAIT_TIMEOUT) {
-			/* FIXME: If we get ER_LOCK_WAIT_TIMEOUT here we need
-			 * to restart the connections, but it appears restarting
-			 * the calling program is the only way to handle this.
-			 * If anyone in the future figures out a way to handle
-			 * this, super.  Until then we will need to restart the
-			 * calling program if you ever get this error.
-			 */
-			fatal("mysql gave ER_LOCK_WAIT_TIMEOUT as an error. "
-			      "The only way to fix this is restart the "
-			      "calling program");
-		} else if (errno == ER_HOST_IS_BLOCKED) {
-			fatal("MySQL gave ER_HOST_IS_BLOCKED as an error. "
-			      "You will need to call 'mysqladmin flush-hosts' "
-			      "to regain connectivity.");
-		}
-		rc = SLURM_ERROR;
+		rc = _handle_query_error("mysql_query", errno,
+					 mysql_error(db_conn), query);
 	}
-end_it:
+
 	/*
 	 * Starting in MariaDB 10.2 many of the api commands started
 	 * setting errno erroneously.
@@ -181,6 +196,47 @@ end_it:
 	return rc;
 }
 
+static void _stmt_close(void *stmt)
+{
+	mysql_stmt_close((MYSQL_STMT *)stmt);
+}
+
+/* Must hold mysql_conn->lock */
+static db_stmt_t *_get_db_stmt(mysql_conn_t *mysql_conn, char *query)
+{
+	db_stmt_t *db_stmt;
+	MYSQL_STMT *stmt;
+
+	if ((db_stmt = stmt_cache_find(mysql_conn->stmt_cache, query)))
+		return db_stmt;
+
+	if (!(stmt = mysql_stmt_init(mysql_conn->db_conn))) {
+		error("mysql_stmt_init failed: %d %s",
+		      mysql_errno(mysql_conn->db_conn),
+		      mysql_error(mysql_conn->db_conn));
+		return NULL;
+	}
+
+	if (mysql_stmt_prepare(stmt, query, strlen(query))) {
+		error("mysql_stmt_prepare failed: %d %s\n%s",
+		      mysql_stmt_errno(stmt), mysql_stmt_error(stmt), query);
+		mysql_stmt_close(stmt);
+		return NULL;
+	}
+
+	return stmt_cache_add(mysql_conn->stmt_cache, query, stmt,
+			      _stmt_close);
+}
+
+static void _bind_init(MYSQL_BIND *bind, enum enum_field_types type,
+		       void *value, bool is_unsigned)
+{
+	memset(bind, 0, sizeof(MYSQL_BIND));
+	bind->buffer_type = type;
+	bind->buffer = value;
+	bind->is_unsigned = is_unsigned;
+}
+
 /* NOTE: Ensure that mysql_conn->lock is NOT set on function entry */
 static int _mysql_make_table_current(mysql_conn_t *mysql_conn, char *table_name,
 				     storage_field_t *fields, char *ending)
@@ -608,6 +664,8 @@ extern mysql_conn_t *create_mysql_conn(int conn_num, bool rollback,
 	mysql_conn->conn = conn_num;
 	mysql_conn->cluster_name = xstrdup(cluster_name);
 	slurm_mutex_init(&mysql_conn->lock);
+	mysql_conn->pending_step_rows = list_create(slurm_destroy_char);
+	mysql_conn->stmt_cache = stmt_cache_create();
 	mysql_conn->update_list = list_create(slurmdb_destroy_update_object);
 
 	return mysql_conn;
@@ -617,9 +675,12 @@ extern int destroy_mysql_conn(mysql_conn_t *mysql_conn)
 {
 	if (mysql_conn) {
 		mysql_db_close_db_connection(mysql_conn);
+		xfree(mysql_conn->pending_step_insert);
+		FREE_NULL_LIST(mysql_conn->pending_step_rows);
 		xfree(mysql_conn->pre_commit_query);
 		xfree(mysql_conn->cluster_name);
 		slurm_mutex_destroy(&mysql_conn->lock);
+		stmt_cache_destroy(mysql_conn->stmt_cache);
 		FREE_NULL_LIST(mysql_conn->update_list);
 		xfree(mysql_conn);
 	}
@@ -683,6 +744,9 @@ extern int mysql_db_get_db_connection(mysql_conn_t *mysql_conn, char *db_name,
 
 	slurm_mutex_lock(&mysql_conn->lock);
 
+	/* Prepared statements go away with the connection */
+	stmt_cache_flush(mysql_conn->stmt_cache);
+
 	if (!(mysql_conn->db_conn = mysql_init(mysql_conn->db_conn))) {
 		slurm_mutex_unlock(&mysql_conn->lock);
 		fatal("mysql_init failed: %s",
@@ -750,6 +814,7 @@ extern int mysql_db_close_db_connection(mysql_conn_t *mysql_conn)
 {
 	slurm_mutex_lock(&mysql_conn->lock);
 	if (mysql_conn && mysql_conn->db_conn) {
+		stmt_cache_flush(mysql_conn->stmt_cache);
 		if (mysql_thread_safe())
 			mysql_thread_end();
 		mysql_close(mysql_conn->db_conn);
@@ -935,6 +1000,90 @@ extern uint64_t mysql_db_insert_ret_id(mysql_conn_t *mysql_conn, char *query)
 
 }
 
+extern int mysql_db_stmt_query(mysql_conn_t *mysql_conn, char *query,
+			       MYSQL_BIND *params)
+{
+	db_stmt_t *db_stmt;
+	MYSQL_STMT *stmt;
+	int rc = SLURM_ERROR, tries = 0;
+	unsigned int err;
+	bool stale;
+	DEF_TIMERS;
+
+	if (!mysql_conn || !mysql_conn->db_conn) {
+		fatal("You haven't inited this storage yet.");
+		return 0;	/* For CLANG false positive */
+	}
+
+	slurm_mutex_lock(&mysql_conn->lock);
+	/* clear out the old results so we don't get a 2014 error */
+	_clear_results(mysql_conn->db_conn);
+again:
+	if (!(db_stmt = _get_db_stmt(mysql_conn, query)))
+		goto end_it;
+	stmt = db_stmt->stmt;
+
+	START_TIMER;
+	if (mysql_stmt_bind_param(stmt, params) ||
+	    mysql_stmt_execute(stmt)) {
+		err = mysql_stmt_errno(stmt);
+		/*
+		 * The statement handle doesn't survive an automatic
+		 * reconnect, so prepare it again once before giving up.
+		 */
+		stale = ((err == CR_SERVER_GONE_ERROR) ||
+			 (err == CR_SERVER_LOST) ||
+			 (err == ER_UNKNOWN_STMT_HANDLER));
+		if (stale && !tries++) {
+			stmt_cache_remove(mysql_conn->stmt_cache, query);
+			goto again;
+		}
+		errno = err;
+		rc = _handle_query_error("mysql_stmt_execute", err,
+					 mysql_stmt_error(stmt), query);
+		if (stale)
+			stmt_cache_remove(mysql_conn->stmt_cache, query);
+		goto end_it;
+	}
+	END_TIMER;
+
+	stmt_cache_exec(db_stmt, DELTA_TIMER);
+	stmt_cache_log(mysql_conn->stmt_cache, STMT_LOG_INTERVAL);
+	rc = SLURM_SUCCESS;
+end_it:
+	/*
+	 * Starting in MariaDB 10.2 many of the api commands started
+	 * setting errno erroneously.
+	 */
+	if (!rc)
+		errno = 0;
+	slurm_mutex_unlock(&mysql_conn->lock);
+	return rc;
+}
+
+extern void mysql_db_bind_int(MYSQL_BIND *bind, int *value)
+{
+	_bind_init(bind, MYSQL_TYPE_LONG, value, false);
+}
+
+extern void mysql_db_bind_uint32(MYSQL_BIND *bind, uint32_t *value)
+{
+	_bind_init(bind, MYSQL_TYPE_LONG, value, true);
+}
+
+extern void mysql_db_bind_uint64(MYSQL_BIND *bind, uint64_t *value)
+{
+	_bind_init(bind, MYSQL_TYPE_LONGLONG, value, true);
+}
+
+extern void mysql_db_bind_str(MYSQL_BIND *bind, char *value)
+{
+	if (!value)
+		value = "";
+	_bind_init(bind, MYSQL_TYPE_STRING, value, false);
+	bind->buffer_length = strlen(value);
+}
+
 extern int mysql_db_create_table(mysql_conn_t *mysql_conn, char *table_name,
 				 storage_field_t *fields, char *ending)
 {
@@ -48,9 +48,11 @@
 #include "slurm/slurm_errno.h"
 #include "src/common/list.h"
 #include "src/common/xstring.h"
+#include "src/database/stmt_cache.h"
 
 #include <mysql.h>
 #include <mysqld_error.h>
+#include <errmsg.h>
 
 typedef enum {
 	SLURM_MYSQL_PLUGIN_NOTSET,
@@ -63,8 +65,13 @@ typedef struct {
 	char *cluster_name;
 	MYSQL *db_conn;
 	pthread_mutex_t lock;
+	char *pending_step_insert; /* "insert into ... values " of
+				    * pending_step_rows */
+	List pending_step_rows;	/* step start rows inserted at commit */
+	uint32_t pending_step_size; /* length of pending_step_rows */
 	char *pre_commit_query;
 	bool rollback;
+	stmt_cache_t *stmt_cache; /* statements prepared on db_conn */
 	List update_list;
 	int conn;
 } mysql_conn_t;
@@ -104,6 +111,23 @@ extern int mysql_db_query_check_after(mysql_conn_t *mysql_conn, char *query);
 
 extern uint64_t mysql_db_insert_ret_id(mysql_conn_t *mysql_conn, char *query);
 
+/*
+ * Execute a statement that doesn't return rows as a server side prepared
+ * statement.  The statement is prepared the first time query is seen on
+ * this connection and reused after that.
+ * IN query - statement template using ? for each parameter
+ * IN params - one MYSQL_BIND per placeholder, see mysql_db_bind_*()
+ * RET SLURM_SUCCESS or SLURM_ERROR
+ */
+extern int mysql_db_stmt_query(mysql_conn_t *mysql_conn, char *query,
+			       MYSQL_BIND *params);
+
+extern void mysql_db_bind_int(MYSQL_BIND *bind, int *value);
+extern void mysql_db_bind_uint32(MYSQL_BIND *bind, uint32_t *value);
+extern void mysql_db_bind_uint64(MYSQL_BIND *bind, uint64_t *value);
+/* A NULL value is bound as an empty string */
+extern void mysql_db_bind_str(MYSQL_BIND *bind, char *value);
+
 extern int mysql_db_create_table(mysql_conn_t *mysql_conn, char *table_name,
 				 storage_field_t *fields, char *ending);
 
@@ -0,0 +1,157 @@
+/*****************************************************************************\
+ *  stmt_cache.c - cache of prepared statements of a database connection
+ *****************************************************************************
+ *  Copyright (C) 2018 SchedMD LLC.
+ *
+ *  This file is part of Slurm, a resource management program.
+ *  For details, see <https://slurm.schedmd.com/>.
+ *  Please also read the included file: DISCLAIMER.
+ *
+ *  Slurm is free software; you can redistribute it and/or modify it under
+ *  the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  In addition, as a special exception, the copyright holders give permission
+ *  to link the code of portions of this program with the OpenSSL library under
+ *  certain conditions as described in each individual source file, and
+ *  distribute linked combinations including the two. You must obey the GNU
+ *  General Public License in all respects for all of the code used other than
+ *  OpenSSL. If you modify file(s) with this exception, you may extend this
+ *  exception to your version of the file(s), but you are not obligated to do
+ *  so. If you do not wish to do so, delete this exception statement from your
+ *  version.  If you delete this exception statement from all source files in
+ *  the program, then also delete it here.
+ *
+ *  Slurm is distributed in the hope that it will be useful, but WITHOUT ANY
+ *  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *  FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ *  details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with Slurm; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA.
+\*****************************************************************************/
+
+#include "src/common/log.h"
+#include "src/common/xmalloc.h"
+#include "src/common/xstring.h"
+
+#include "src/database/stmt_cache.h"
+
+static void _destroy_db_stmt(void *arg)
+{
+	db_stmt_t *db_stmt = (db_stmt_t *)arg;
+
+	if (db_stmt) {
+		if (db_stmt->stmt && db_stmt->stmt_close)
+			(db_stmt->stmt_close)(db_stmt->stmt);
+		xfree(db_stmt->query);
+		xfree(db_stmt);
+	}
+}
+
+static int _find_db_stmt(void *x, void *key)
+{
+	db_stmt_t *db_stmt = (db_stmt_t *)x;
+
+	if (!xstrcmp(db_stmt->query, (char *)key))
+		return 1;
+
+	return 0;
+}
+
+static int _print_db_stmt(void *x, void *arg)
+{
+	db_stmt_t *db_stmt = (db_stmt_t *)x;
+
+	debug("prepared statement: %"PRIu64" runs, ave %"PRIu64" usec, "
+	      "max %"PRIu64" usec: %s",
+	      db_stmt->exec_cnt,
+	      db_stmt->exec_cnt ? db_stmt->exec_time / db_stmt->exec_cnt : 0,
+	      db_stmt->exec_max_time, db_stmt->query);
+
+	return 0;
+}
+
+extern stmt_cache_t *stmt_cache_create(void)
+{
+	stmt_cache_t *cache = xmalloc(sizeof(stmt_cache_t));
+
+	cache->log_time = time(NULL);
+	cache->stmt_list = list_create(_destroy_db_stmt);
+
+	return cache;
+}
+
+extern void stmt_cache_destroy(stmt_cache_t *cache)
+{
+	if (cache) {
+		FREE_NULL_LIST(cache->stmt_list);
+		xfree(cache);
+	}
+}
+
+extern db_stmt_t *stmt_cache_find(stmt_cache_t *cache, char *query)
+{
+	db_stmt_t *db_stmt;
+
+	if ((db_stmt = list_find_first(cache->stmt_list, _find_db_stmt,
+				       query)))
+		cache->hits++;
+	else
+		cache->misses++;
+
+	return db_stmt;
+}
+
+extern db_stmt_t *stmt_cache_add(stmt_cache_t *cache, char *query,
+				 void *stmt, void (*stmt_close)(void *stmt))
+{
+	db_stmt_t *db_stmt = xmalloc(sizeof(db_stmt_t));
+
+	db_stmt->query = xstrdup(query);
+	db_stmt->stmt = stmt;
+	db_stmt->stmt_close = stmt_close;
+	list_append(cache->stmt_list, db_stmt);
+
+	return db_stmt;
+}
+
+extern void stmt_cache_remove(stmt_cache_t *cache, char *query)
+{
+	list_delete_all(cache->stmt_list, _find_db_stmt, query);
+}
+
+extern void stmt_cache_exec(db_stmt_t *db_stmt, uint64_t usec)
+{
+	db_stmt->exec_cnt++;
+	db_stmt->exec_time += usec;
+	if (usec > db_stmt->exec_max_time)
+		db_stmt->exec_max_time = usec;
+}
+
+extern void stmt_cache_log(stmt_cache_t *cache, time_t interval)
+{
+	time_t now = time(NULL);
+	uint64_t lookups = cache->hits + cache->misses;
+
+	if (interval && ((now < (cache->log_time + interval)) ||
+			 (lookups == cache->log_lookups)))
+		return;
+
+	cache->log_time = now;
+	cache->log_lookups = lookups;
+	info("prepared statement cache: %d statements, %"PRIu64" hits %"PRIu64" misses",
+	     list_count(cache->stmt_list), cache->hits, cache->misses);
+	list_for_each(cache->stmt_list, _print_db_stmt, NULL);
+}
+
+extern void stmt_cache_flush(stmt_cache_t *cache)
+{
+	if (list_is_empty(cache->stmt_list))
+		return;
+
+	stmt_cache_log(cache, 0);
+	list_flush(cache->stmt_list);
+}
@@ -0,0 +1,102 @@
+/*****************************************************************************\
+ *  stmt_cache.h - cache of prepared statements of a database connection
+ *****************************************************************************
+ *  Copyright (C) 2018 SchedMD LLC.
+ *
+ *  This file is part of Slurm, a resource management program.
+ *  For details, see <https://slurm.schedmd.com/>.
+ *  Please also read the included file: DISCLAIMER.
+ *
+ *  Slurm is free software; you can redistribute it and/or modify it under
+ *  the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  In addition, as a special exception, the copyright holders give permission
+ *  to link the code of portions of this program with the OpenSSL library under
+ *  certain conditions as described in each individual source file, and
+ *  distribute linked combinations including the two. You must obey the GNU
+ *  General Public License in all respects for all of the code used other than
+ *  OpenSSL. If you modify file(s) with this exception, you may extend this
+ *  exception to your version of the file(s), but you are not obligated to do
+ *  so. If you do not wish to do so, delete this exception statement from your
+ *  version.  If you delete this exception statement from all source files in
+ *  the program, then also delete it here.
+ *
+ *  Slurm is distributed in the hope that it will be useful, but WITHOUT ANY
+ *  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *  FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ *  details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with Slurm; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA.
+\*****************************************************************************/
+
+#ifndef _STMT_CACHE_H
+#define _STMT_CACHE_H
+
+#include <inttypes.h>
+#include <time.h>
+
+#include "src/common/list.h"
+
+/*
+ * Prepared statements of one database connection, keyed by their query
+ * template. The cache does no locking of its own, callers serialize access
+ * with the lock of the connection.
+ */
+
+typedef struct {
+	uint64_t exec_cnt;
+	uint64_t exec_time;	/* total usec spent executing */
+	uint64_t exec_max_time;	/* longest execution in usec */
+	char *query;		/* statement template with ? placeholders */
+	void *stmt;		/* database handle of the statement */
+	void (*stmt_close)(void *stmt);
+} db_stmt_t;
+
+typedef struct {
+	uint64_t hits;		/* lookups that found a prepared stmt */
+	uint64_t misses;	/* lookups that had to prepare one */
+	uint64_t log_lookups;	/* hits + misses when last logged */
+	time_t log_time;	/* last time the statistics were logged */
+	List stmt_list;		/* list of db_stmt_t's */
+} stmt_cache_t;
+
+extern stmt_cache_t *stmt_cache_create(void);
+extern void stmt_cache_destroy(stmt_cache_t *cache);
+
+/*
+ * Find the prepared statement for a query template
+ * RET statement or NULL if it must be prepared and added first
+ */
+extern db_stmt_t *stmt_cache_find(stmt_cache_t *cache, char *query);
+
+/*
+ * Add a newly prepared statement to the cache
+ * IN query - statement template, copied
+ * IN stmt - database handle, closed with stmt_close when removed
+ */
+extern db_stmt_t *stmt_cache_add(stmt_cache_t *cache, char *query,
+				 void *stmt, void (*stmt_close)(void *stmt));
+
+/* Close and remove the statement of a query template, if any */
+extern void stmt_cache_remove(stmt_cache_t *cache, char *query);
+
+/* Record one execution of a statement taking usec microseconds */
+extern void stmt_cache_exec(db_stmt_t *db_stmt, uint64_t usec);
+
+/*
+ * Log the cache statistics, at most once per interval seconds and only if
+ * the cache was used since the last time. An interval of 0 always logs.
+ */
+extern void stmt_cache_log(stmt_cache_t *cache, time_t interval);
+
+/*
+ * Log the statistics then close and remove every statement, as their
+ * handles do not survive the connection being closed or reinitialized
+ */
+extern void stmt_cache_flush(stmt_cache_t *cache);
+
+#endif
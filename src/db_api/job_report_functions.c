@@ -154,7 +154,7 @@ static List _process_grouped_report(
 	slurmdb_report_acct_grouping_t *acct_group = NULL;
 	slurmdb_report_job_grouping_t *job_group = NULL;
 
-	List job_list = NULL;
+	List job_list = NULL, job_tres_list = NULL;
 	List cluster_list = NULL;
 	List object_list = NULL, object2_list = NULL;
 
@@ -182,7 +182,8 @@ static List _process_grouped_report(
 
 	tmp_acct_list = job_cond->acct_list;
 	job_cond->acct_list = NULL;
-	job_cond->flags |= JOBCOND_FLAG_DUP;
+	/* Steps are never looked at here, don't transfer them */
+	job_cond->flags |= JOBCOND_FLAG_DUP | JOBCOND_FLAG_NO_STEP;
 
 	job_list = jobacct_storage_g_get_jobs_cond(db_conn, my_uid, job_cond);
 	job_cond->acct_list = tmp_acct_list;
@@ -331,12 +332,21 @@ no_objects:
 	while((job = list_next(itr))) {
 		char *local_cluster = "UNKNOWN";
 		char tmp_acct[200];
+		slurmdb_tres_rec_t *tres_rec;
+		uint64_t count;
 
 		if (!job->elapsed) {
 			/* here we don't care about jobs that didn't
 			 * really run here */
 			continue;
 		}
+
+		/* Parse the TRES once, every grouping level uses them */
+		FREE_NULL_LIST(job_tres_list);
+		slurmdb_tres_list_from_string(&job_tres_list,
+					      job->tres_alloc_str,
+					      TRES_STR_FLAG_NONE);
+
 		if (job->cluster)
 			local_cluster = job->cluster;
 
@@ -463,14 +473,20 @@ no_objects:
 			list_iterator_reset(group_itr);
 		}
 
+		/*
+		 * Jobs without the TRES still create their groupings above,
+		 * they just aren't counted in any of them.
+		 */
+		if (!job_tres_list ||
+		    !(tres_rec = list_find_first(job_tres_list,
+						 slurmdb_find_tres_in_list,
+						 &tres_id)))
+			continue;
+		count = tres_rec->count;
+
 		local_itr = list_iterator_create(acct_group->groups);
 		while ((job_group = list_next(local_itr))) {
-			uint64_t count;
-
-			if (((count = slurmdb_find_tres_count_in_string(
-				      job->tres_alloc_str, tres_id))
-			     == INFINITE64) ||
-			    (count < job_group->min_size) ||
+			if ((count < job_group->min_size) ||
 			    (count > job_group->max_size))
 				continue;
 
@@ -479,19 +495,20 @@ no_objects:
 			acct_group->count++;
 			cluster_group->count++;
 
-			slurmdb_transfer_tres_time(
-				&job_group->tres_list, job->tres_alloc_str,
+			slurmdb_transfer_tres_list_time(
+				&job_group->tres_list, job_tres_list,
 				job->elapsed);
-			slurmdb_transfer_tres_time(
-				&acct_group->tres_list, job->tres_alloc_str,
+			slurmdb_transfer_tres_list_time(
+				&acct_group->tres_list, job_tres_list,
 				job->elapsed);
-			slurmdb_transfer_tres_time(
-				&cluster_group->tres_list, job->tres_alloc_str,
+			slurmdb_transfer_tres_list_time(
+				&cluster_group->tres_list, job_tres_list,
 				job->elapsed);
 		}
 		list_iterator_destroy(local_itr);
 	}
 	list_iterator_destroy(itr);
+	FREE_NULL_LIST(job_tres_list);
 	list_iterator_destroy(group_itr);
 	list_iterator_reset(cluster_itr);
 	while ((cluster_group = list_next(cluster_itr))) {
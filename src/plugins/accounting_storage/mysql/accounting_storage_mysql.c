@@ -1142,6 +1142,7 @@ extern void reset_mysql_conn(mysql_conn_t *mysql_conn)
 {
 	if (mysql_conn->rollback)
 		mysql_db_rollback(mysql_conn);
+	xfree(mysql_conn->pending_step_insert);
 	xfree(mysql_conn->pre_commit_query);
 	list_flush(mysql_conn->update_list);
 }
@@ -2552,10 +2553,19 @@ extern int acct_storage_p_commit(mysql_conn_t *mysql_conn, bool commit)
 
 	if (mysql_conn->rollback) {
 		if (!commit) {
+			as_mysql_step_start_discard(mysql_conn);
 			if (mysql_db_rollback(mysql_conn))
 				error("rollback failed");
 		} else {
 			int rc = SLURM_SUCCESS;
+			/*
+			 * The step records are retried one at a time if the
+			 * batch fails, so only the bad ones are lost. Don't
+			 * throw away the rest of the transaction for them.
+			 */
+			if (as_mysql_step_start_flush(mysql_conn))
+				error("%s: couldn't add some batched step records",
+				      __func__);
 			/*
 			 * Handle anything here we were unable to do
 			 * because of rollback issues.
@@ -65,6 +65,9 @@
 #define MAX_ARCHIVE_AGE (60 * 60 * 24 * 60) /* If archive data is older than
 					       this then archive by month to
 					       handle large datasets. */
+#define MAX_ARCHIVE_RECORDS 100000 /* Number of records archived to one file
+				      so memory use and row locks stay
+				      bounded on large purges. */
 
 typedef struct {
 	char *cluster_nodes;
@@ -3128,7 +3131,7 @@ static uint32_t _archive_table(purge_type_t type, mysql_conn_t *mysql_conn,
 		break;
 	case PURGE_JOB:
 		query = xstrdup_printf("select %s from \"%s_%s\" where "
-				       "time_submit < %ld && time_end != 0 "
+				       "time_submit <= %ld && time_end != 0 "
 				       "order by time_submit asc for update",
 				       cols, cluster_name, job_table,
 				       period_end);
@@ -3254,6 +3257,63 @@ static int _get_oldest_record(mysql_conn_t *mysql_conn, char *cluster,
 	return 1; /* found one record */
 }
 
+/*
+ * Return the end time of the next archive chunk, at most period_end, so the
+ * chunk holds about MAX_ARCHIVE_RECORDS records.  Records sharing a time
+ * stamp are never split between chunks, so a chunk may be larger if many
+ * records have the time stamp record_start.
+ */
+static time_t _get_chunk_end(mysql_conn_t *mysql_conn, char *cluster,
+			     char *table, purge_type_t type, char *col_name,
+			     time_t record_start, time_t period_end)
+{
+	MYSQL_RES *result = NULL;
+	MYSQL_ROW row;
+	char *query = NULL;
+	time_t chunk_end = period_end;
+
+	switch (type) {
+	case PURGE_TXN:
+		query = xstrdup_printf(
+			"select %s from \"%s\" where %s <= %ld "
+			"&& cluster='%s' order by %s asc LIMIT 1 OFFSET %d",
+			col_name, table, col_name, period_end, cluster,
+			col_name, MAX_ARCHIVE_RECORDS);
+		break;
+	case PURGE_USAGE:
+	case PURGE_CLUSTER_USAGE:
+		query = xstrdup_printf(
+			"select %s from \"%s_%s\" where %s <= %ld "
+			"order by %s asc LIMIT 1 OFFSET %d",
+			col_name, cluster, table, col_name, period_end,
+			col_name, MAX_ARCHIVE_RECORDS);
+		break;
+	default:
+		query = xstrdup_printf(
+			"select %s from \"%s_%s\" where %s <= %ld "
+			"&& time_end != 0 order by %s asc LIMIT 1 OFFSET %d",
+			col_name, cluster, table, col_name, period_end,
+			col_name, MAX_ARCHIVE_RECORDS);
+		break;
+	}
+
+	if (debug_flags & DEBUG_FLAG_DB_ARCHIVE)
+		DB_DEBUG(mysql_conn->conn, "query\n%s", query);
+	result = mysql_db_query_ret(mysql_conn, query, 0);
+	xfree(query);
+	if (!result)	/* Fall back to archiving the whole period */
+		return period_end;
+
+	if ((row = mysql_fetch_row(result))) {
+		chunk_end = slurm_atoul(row[0]) - 1;
+		if (chunk_end < record_start)
+			chunk_end = record_start;
+	}
+	mysql_free_result(result);
+
+	return chunk_end;
+}
+
 /* Archive and purge a table.
  *
  * Returns SLURM_ERROR on error and SLURM_SUCCESS on success.
@@ -3401,6 +3461,17 @@ static int _archive_purge_table(purge_type_t purge_type, uint32_t usage_info,
 		} else
 			tmp_end = curr_end;
 
+		/*
+		 * Archive and purge in bounded chunks.  Each chunk is written
+		 * to its own file and purged before the next one is read, so
+		 * an interrupted run picks up where it left off.
+		 */
+		if (SLURMDB_PURGE_ARCHIVE_SET(purge_attr))
+			tmp_end = _get_chunk_end(mysql_conn, cluster_name,
+						 sql_table, purge_type,
+						 col_name, record_start,
+						 tmp_end);
+
 		if (debug_flags & DEBUG_FLAG_DB_ARCHIVE)
 			debug("Purging %s_%s before %ld",
 			      cluster_name, sql_table, tmp_end);
@@ -3638,9 +3709,12 @@ extern int as_mysql_jobacct_process_archive_load(
 				data[data_size + data_read] = '\0';
 				if (data_read == 0)	/* eof */
 					break;
-				data_size      += data_read;
-				data_allocated += data_read;
-				xrealloc_nz(data, data_allocated);
+				data_size += data_read;
+				if ((data_allocated - data_size) <= BUF_SIZE) {
+					/* Grow geometrically on big files */
+					data_allocated *= 2;
+					xrealloc_nz(data, data_allocated);
+				}
 			}
 			close(state_fd);
 		}
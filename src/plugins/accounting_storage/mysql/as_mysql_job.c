@@ -40,6 +40,7 @@
 #include "as_mysql_job.h"
 #include "as_mysql_usage.h"
 #include "as_mysql_wckey.h"
+#include "../common/multi_insert.h"
 
 #include "src/common/assoc_mgr.h"
 #include "src/common/gres.h"
@@ -49,6 +50,10 @@
 #include "src/common/slurm_time.h"
 
 #define BUFFER_SIZE 4096
+/* Run a pending multi-row step insert once it grows past this many bytes */
+#define STEP_INSERT_MAX (1024 * 1024)
+/* Placeholders in the step completion update */
+#define STEP_COMP_PARAMS 28
 
 static char *_average_tres_usage(uint32_t *tres_ids, uint64_t *tres_cnts,
 				 int tres_cnt, int tasks)
@@ -263,7 +268,13 @@ static char *_set_energy_tres(mysql_conn_t *mysql_conn,
 	char *tres_alloc_str = NULL;
 	MYSQL_RES *result = NULL;
 	MYSQL_ROW row;
-	char * query = xstrdup_printf(
+	char *query = NULL;
+
+	/* The step energy is summed below, so the steps must be there */
+	if (as_mysql_step_start_flush(mysql_conn) != SLURM_SUCCESS)
+		return NULL;
+
+	query = xstrdup_printf(
 		"select job.tres_alloc, SUM(consumed_energy) from "
 		"\"%s_%s\" as job left outer join \"%s_%s\" "
 		"as step on job.job_db_inx=step.job_db_inx "
@@ -1197,40 +1208,111 @@ extern int as_mysql_step_start(mysql_conn_t *mysql_conn,
 		}
 	}
 
-	/* we want to print a -1 for the requid so leave it a
-	   %d */
+	/*
+	 * Append this step to the pending multi-row insert.  In a
+	 * transaction (slurmdbd) it is run at commit, or earlier if it gets
+	 * large or something needs to read the step table, otherwise it is
+	 * run now.
+	 */
+	if (!mysql_conn->pending_step_insert)
+		mysql_conn->pending_step_insert = xstrdup_printf(
+			"insert into \"%s_%s\" (job_db_inx, id_step, "
+			"time_start, step_name, state, tres_alloc, "
+			"nodes_alloc, task_cnt, nodelist, node_inx, "
+			"task_dist, req_cpufreq, req_cpufreq_min, "
+			"req_cpufreq_gov) values ",
+			mysql_conn->cluster_name, step_table);
 	/* The stepid could be -2 so use %d not %u */
 	query = xstrdup_printf(
-		"insert into \"%s_%s\" (job_db_inx, id_step, time_start, "
-		"step_name, state, tres_alloc, "
-		"nodes_alloc, task_cnt, nodelist, node_inx, "
-		"task_dist, req_cpufreq, req_cpufreq_min, req_cpufreq_gov) "
-		"values (%"PRIu64", %d, %d, '%s', %d, '%s', %d, %d, "
-		"'%s', '%s', %d, %u, %u, %u) "
-		"on duplicate key update "
-		"nodes_alloc=%d, task_cnt=%d, time_end=0, state=%d, "
-		"nodelist='%s', node_inx='%s', task_dist=%d, "
-		"req_cpufreq=%u, req_cpufreq_min=%u, req_cpufreq_gov=%u,"
-		"tres_alloc='%s';",
-		mysql_conn->cluster_name, step_table,
+		"(%"PRIu64", %d, %d, '%s', %d, '%s', %d, %d, "
+		"'%s', '%s', %d, %u, %u, %u)",
 		step_ptr->job_ptr->db_index,
 		step_ptr->step_id,
 		(int)start_time, step_ptr->name,
 		JOB_RUNNING, step_ptr->tres_alloc_str,
 		nodes, tasks, node_list, node_inx, task_dist,
 		step_ptr->cpu_freq_max, step_ptr->cpu_freq_min,
-		step_ptr->cpu_freq_gov, nodes, tasks, JOB_RUNNING,
-		node_list, node_inx, task_dist, step_ptr->cpu_freq_max,
-		step_ptr->cpu_freq_min, step_ptr->cpu_freq_gov,
-		step_ptr->tres_alloc_str);
+		step_ptr->cpu_freq_gov);
+	mysql_conn->pending_step_size += strlen(query);
+	list_append(mysql_conn->pending_step_rows, query);
+
+	if (!mysql_conn->rollback ||
+	    (mysql_conn->pending_step_size > STEP_INSERT_MAX))
+		rc = as_mysql_step_start_flush(mysql_conn);
+
+	return rc;
+}
+
+extern int as_mysql_step_start_flush(mysql_conn_t *mysql_conn)
+{
+	static char *suffix =
+		" on duplicate key update "
+		"nodes_alloc=VALUES(nodes_alloc), task_cnt=VALUES(task_cnt), "
+		"time_end=0, state=VALUES(state), "
+		"nodelist=VALUES(nodelist), node_inx=VALUES(node_inx), "
+		"task_dist=VALUES(task_dist), "
+		"req_cpufreq=VALUES(req_cpufreq), "
+		"req_cpufreq_min=VALUES(req_cpufreq_min), "
+		"req_cpufreq_gov=VALUES(req_cpufreq_gov), "
+		"tres_alloc=VALUES(tres_alloc);";
+	ListIterator itr;
+	List row_list;
+	char *query, *row;
+	int rc;
+
+	if (!(query = build_multi_insert(mysql_conn->pending_step_insert,
+					 mysql_conn->pending_step_rows,
+					 suffix)))
+		return SLURM_SUCCESS;
+
 	if (debug_flags & DEBUG_FLAG_DB_STEP)
 		DB_DEBUG(mysql_conn->conn, "query\n%s", query);
 	rc = mysql_db_query(mysql_conn, query);
 	xfree(query);
 
+	/*
+	 * One bad row fails the whole statement, retry the rows one at a
+	 * time so that only the bad ones are lost.
+	 */
+	if ((rc != SLURM_SUCCESS) &&
+	    (list_count(mysql_conn->pending_step_rows) > 1)) {
+		error("%s: couldn't add %d step records at once, adding them one at a time",
+		      __func__, list_count(mysql_conn->pending_step_rows));
+		rc = SLURM_SUCCESS;
+		row_list = list_create(NULL);
+		itr = list_iterator_create(mysql_conn->pending_step_rows);
+		while ((row = list_next(itr))) {
+			list_append(row_list, row);
+			query = build_multi_insert(
+				mysql_conn->pending_step_insert, row_list,
+				suffix);
+			list_flush(row_list);
+			if (debug_flags & DEBUG_FLAG_DB_STEP)
+				DB_DEBUG(mysql_conn->conn, "query\n%s", query);
+			if (mysql_db_query(mysql_conn, query) !=
+			    SLURM_SUCCESS) {
+				error("%s: couldn't add step record %s",
+				      __func__, row);
+				rc = SLURM_ERROR;
+			}
+			xfree(query);
+		}
+		list_iterator_destroy(itr);
+		FREE_NULL_LIST(row_list);
+	}
+
+	as_mysql_step_start_discard(mysql_conn);
+
 	return rc;
 }
 
+extern void as_mysql_step_start_discard(mysql_conn_t *mysql_conn)
+{
+	xfree(mysql_conn->pending_step_insert);
+	list_flush(mysql_conn->pending_step_rows);
+	mysql_conn->pending_step_size = 0;
+}
+
 extern int as_mysql_step_complete(mysql_conn_t *mysql_conn,
 				  struct step_record *step_ptr)
 {
@@ -1242,6 +1324,12 @@ extern int as_mysql_step_complete(mysql_conn_t *mysql_conn,
 	int rc = SLURM_SUCCESS;
 	uint32_t exit_code = 0;
 	time_t submit_time;
+	MYSQL_BIND params[STEP_COMP_PARAMS];
+	int param_cnt = 0, end_time, requid, step_id;
+	uint32_t state;
+	slurmdb_stats_t stats;
+
+	memset(&stats, 0, sizeof(slurmdb_stats_t));
 
 	if (!step_ptr->job_ptr->db_index
 	    && ((!step_ptr->job_ptr->details
@@ -1260,6 +1348,10 @@ extern int as_mysql_step_complete(mysql_conn_t *mysql_conn,
 	if (check_connection(mysql_conn) != SLURM_SUCCESS)
 		return ESLURM_DB_CONNECTION;
 
+	/* The step record may still be waiting in a multi-row insert */
+	if ((rc = as_mysql_step_start_flush(mysql_conn)) != SLURM_SUCCESS)
+		return rc;
+
 	if (slurmdbd_conf) {
 		now = step_ptr->job_ptr->end_time;
 		if (step_ptr->job_ptr->details)
@@ -1325,21 +1417,23 @@ extern int as_mysql_step_complete(mysql_conn_t *mysql_conn,
 		}
 	}
 
-	/* The stepid could be -2 so use %d not %u */
+	/*
+	 * This runs for every step, so it goes through a prepared
+	 * statement; the values are bound below in placeholder order.
+	 */
 	query = xstrdup_printf(
-		"update \"%s_%s\" set time_end=%d, state=%u, "
-		"kill_requid=%d, exit_code=%d",
-		mysql_conn->cluster_name, step_table, (int)now,
-		comp_status,
-		step_ptr->requid,
-		exit_code);
-
+		"update \"%s_%s\" set time_end=?, state=?, "
+		"kill_requid=?, exit_code=?",
+		mysql_conn->cluster_name, step_table);
+	end_time = (int)now;
+	state = comp_status;
+	requid = (int)step_ptr->requid;
+	mysql_db_bind_int(&params[param_cnt++], &end_time);
+	mysql_db_bind_uint32(&params[param_cnt++], &state);
+	mysql_db_bind_int(&params[param_cnt++], &requid);
+	mysql_db_bind_int(&params[param_cnt++], (int *)&exit_code);
 
 	if (jobacct) {
-		slurmdb_stats_t stats;
-
-		memset(&stats, 0, sizeof(slurmdb_stats_t));
-
 		/* figure out the ave of the totals sent */
 		if (tasks > 0) {
 			stats.tres_usage_in_ave =
@@ -1416,78 +1510,106 @@ extern int as_mysql_step_complete(mysql_conn_t *mysql_conn,
 			jobacct->tres_usage_out_tot,
 			jobacct->tres_count, 1);
 
-		xstrfmtcat(query,
-			   ", user_sec=%u, user_usec=%u, "
-			   "sys_sec=%u, sys_usec=%u, "
-			   "act_cpufreq=%u, consumed_energy=%"PRIu64", "
-			   "tres_usage_in_ave='%s', "
-			   "tres_usage_out_ave='%s', "
-			   "tres_usage_in_max='%s', "
-			   "tres_usage_in_max_taskid='%s', "
-			   "tres_usage_in_max_nodeid='%s', "
-			   "tres_usage_in_min='%s', "
-			   "tres_usage_in_min_taskid='%s', "
-			   "tres_usage_in_min_nodeid='%s', "
-			   "tres_usage_in_tot='%s', "
-			   "tres_usage_out_max='%s', "
-			   "tres_usage_out_max_taskid='%s', "
-			   "tres_usage_out_max_nodeid='%s', "
-			   "tres_usage_out_min='%s', "
-			   "tres_usage_out_min_taskid='%s', "
-			   "tres_usage_out_min_nodeid='%s', "
-			   "tres_usage_out_tot='%s'",
-			   /* user seconds */
-			   jobacct->user_cpu_sec,
-			   /* user microseconds */
-			   jobacct->user_cpu_usec,
-			   /* system seconds */
-			   jobacct->sys_cpu_sec,
-			   /* system microsecs */
-			   jobacct->sys_cpu_usec,
-			   jobacct->act_cpufreq,
-			   jobacct->energy.consumed_energy,
-			   stats.tres_usage_in_ave,
-			   stats.tres_usage_out_ave,
-			   stats.tres_usage_in_max,
-			   stats.tres_usage_in_max_taskid,
-			   stats.tres_usage_in_max_nodeid,
-			   stats.tres_usage_in_min,
-			   stats.tres_usage_in_min_taskid,
-			   stats.tres_usage_in_min_nodeid,
-			   stats.tres_usage_in_tot,
-			   stats.tres_usage_out_max,
-			   stats.tres_usage_out_max_taskid,
-			   stats.tres_usage_out_max_nodeid,
-			   stats.tres_usage_out_min,
-			   stats.tres_usage_out_min_taskid,
-			   stats.tres_usage_out_min_nodeid,
-			   stats.tres_usage_out_tot);
-
-		slurmdb_free_slurmdb_stats_members(&stats);
+		xstrcat(query,
+			", user_sec=?, user_usec=?, "
+			"sys_sec=?, sys_usec=?, "
+			"act_cpufreq=?, consumed_energy=?, "
+			"tres_usage_in_ave=?, "
+			"tres_usage_out_ave=?, "
+			"tres_usage_in_max=?, "
+			"tres_usage_in_max_taskid=?, "
+			"tres_usage_in_max_nodeid=?, "
+			"tres_usage_in_min=?, "
+			"tres_usage_in_min_taskid=?, "
+			"tres_usage_in_min_nodeid=?, "
+			"tres_usage_in_tot=?, "
+			"tres_usage_out_max=?, "
+			"tres_usage_out_max_taskid=?, "
+			"tres_usage_out_max_nodeid=?, "
+			"tres_usage_out_min=?, "
+			"tres_usage_out_min_taskid=?, "
+			"tres_usage_out_min_nodeid=?, "
+			"tres_usage_out_tot=?");
+		mysql_db_bind_uint32(&params[param_cnt++],
+				     &jobacct->user_cpu_sec);
+		mysql_db_bind_uint32(&params[param_cnt++],
+				     &jobacct->user_cpu_usec);
+		mysql_db_bind_uint32(&params[param_cnt++],
+				     &jobacct->sys_cpu_sec);
+		mysql_db_bind_uint32(&params[param_cnt++],
+				     &jobacct->sys_cpu_usec);
+		mysql_db_bind_uint32(&params[param_cnt++],
+				     &jobacct->act_cpufreq);
+		mysql_db_bind_uint64(&params[param_cnt++],
+				     &jobacct->energy.consumed_energy);
+		mysql_db_bind_str(&params[param_cnt++],
+				  stats.tres_usage_in_ave);
+		mysql_db_bind_str(&params[param_cnt++],
+				  stats.tres_usage_out_ave);
+		mysql_db_bind_str(&params[param_cnt++],
+				  stats.tres_usage_in_max);
+		mysql_db_bind_str(&params[param_cnt++],
+				  stats.tres_usage_in_max_taskid);
+		mysql_db_bind_str(&params[param_cnt++],
+				  stats.tres_usage_in_max_nodeid);
+		mysql_db_bind_str(&params[param_cnt++],
+				  stats.tres_usage_in_min);
+		mysql_db_bind_str(&params[param_cnt++],
+				  stats.tres_usage_in_min_taskid);
+		mysql_db_bind_str(&params[param_cnt++],
+				  stats.tres_usage_in_min_nodeid);
+		mysql_db_bind_str(&params[param_cnt++],
+				  stats.tres_usage_in_tot);
+		mysql_db_bind_str(&params[param_cnt++],
+				  stats.tres_usage_out_max);
+		mysql_db_bind_str(&params[param_cnt++],
+				  stats.tres_usage_out_max_taskid);
+		mysql_db_bind_str(&params[param_cnt++],
+				  stats.tres_usage_out_max_nodeid);
+		mysql_db_bind_str(&params[param_cnt++],
+				  stats.tres_usage_out_min);
+		mysql_db_bind_str(&params[param_cnt++],
+				  stats.tres_usage_out_min_taskid);
+		mysql_db_bind_str(&params[param_cnt++],
+				  stats.tres_usage_out_min_nodeid);
+		mysql_db_bind_str(&params[param_cnt++],
+				  stats.tres_usage_out_tot);
 	}
 
-	/* id_step has to be %d here to handle the -2 -1 for the batch and
-	   extern steps.  Don't change it to a %u.
+	/* id_step has to be signed here to handle the -2 -1 for the batch
+	   and extern steps.  Don't change it to unsigned.
 	*/
-	xstrfmtcat(query,
-		   " where job_db_inx=%"PRIu64" and id_step=%d",
-		   step_ptr->job_ptr->db_index, step_ptr->step_id);
+	xstrcat(query, " where job_db_inx=? and id_step=?");
+	step_id = (int)step_ptr->step_id;
+	mysql_db_bind_uint64(&params[param_cnt++],
+			     &step_ptr->job_ptr->db_index);
+	mysql_db_bind_int(&params[param_cnt++], &step_id);
+	xassert(param_cnt <= STEP_COMP_PARAMS);
+
 	if (debug_flags & DEBUG_FLAG_DB_STEP)
-		DB_DEBUG(mysql_conn->conn, "query\n%s", query);
-	rc = mysql_db_query(mysql_conn, query);
+		DB_DEBUG(mysql_conn->conn, "query\n%s\njob_db_inx=%"PRIu64
+			 " id_step=%d", query, step_ptr->job_ptr->db_index,
+			 step_id);
+	rc = mysql_db_stmt_query(mysql_conn, query, params);
 	xfree(query);
+	slurmdb_free_slurmdb_stats_members(&stats);
 
 	/* set the energy for the entire job. */
 	if (step_ptr->job_ptr->tres_alloc_str) {
 		query = xstrdup_printf(
-			"update \"%s_%s\" set tres_alloc='%s' where "
-			"job_db_inx=%"PRIu64,
-			mysql_conn->cluster_name, job_table,
-			step_ptr->job_ptr->tres_alloc_str,
-			step_ptr->job_ptr->db_index);
+			"update \"%s_%s\" set tres_alloc=? where "
+			"job_db_inx=?",
+			mysql_conn->cluster_name, job_table);
+		mysql_db_bind_str(&params[0],
+				  step_ptr->job_ptr->tres_alloc_str);
+		mysql_db_bind_uint64(&params[1],
+				     &step_ptr->job_ptr->db_index);
 		if (debug_flags & DEBUG_FLAG_DB_STEP)
-			DB_DEBUG(mysql_conn->conn, "query\n%s", query);
-		rc = mysql_db_query(mysql_conn, query);
+			DB_DEBUG(mysql_conn->conn, "query\n%s\n"
+				 "tres_alloc='%s' job_db_inx=%"PRIu64,
+				 query, step_ptr->job_ptr->tres_alloc_str,
+				 step_ptr->job_ptr->db_index);
+		rc = mysql_db_stmt_query(mysql_conn, query, params);
 		xfree(query);
 	}
 
@@ -1506,6 +1628,10 @@ extern int as_mysql_suspend(mysql_conn_t *mysql_conn,
 	if (check_connection(mysql_conn) != SLURM_SUCCESS)
 		return ESLURM_DB_CONNECTION;
 
+	/* Pending step inserts must exist before they are updated */
+	if ((rc = as_mysql_step_start_flush(mysql_conn)) != SLURM_SUCCESS)
+		return rc;
+
 	if (job_ptr->resize_time)
 		submit_time = job_ptr->resize_time;
 	else
@@ -1604,6 +1730,9 @@ extern int as_mysql_flush_jobs_on_cluster(
 	if (check_connection(mysql_conn) != SLURM_SUCCESS)
 		return ESLURM_DB_CONNECTION;
 
+	if ((rc = as_mysql_step_start_flush(mysql_conn)) != SLURM_SUCCESS)
+		return rc;
+
 	/* First we need to get the job_db_inx's and states so we can clean up
 	 * the suspend table and the step table
 	 */
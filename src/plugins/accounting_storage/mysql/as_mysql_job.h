@@ -55,6 +55,16 @@ extern int as_mysql_job_complete(mysql_conn_t *mysql_conn,
 extern int as_mysql_step_start(mysql_conn_t *mysql_conn,
 			    struct step_record *step_ptr);
 
+/*
+ * Run any step start records waiting in a multi-row insert. If the
+ * multi-row insert fails the records are retried one at a time.
+ * RET SLURM_SUCCESS, or SLURM_ERROR if any record could not be added
+ */
+extern int as_mysql_step_start_flush(mysql_conn_t *mysql_conn);
+
+/* Throw away any step start records waiting in a multi-row insert */
+extern void as_mysql_step_start_discard(mysql_conn_t *mysql_conn);
+
 extern int as_mysql_step_complete(mysql_conn_t *mysql_conn,
 			       struct step_record *step_ptr);
 
@@ -373,7 +373,9 @@ static int _cluster_get_jobs(mysql_conn_t *mysql_conn,
 			     char *cluster_name,
 			     char *job_fields, char *step_fields,
 			     char *sent_extra,
-			     bool is_admin, int only_pending, List sent_list)
+			     bool is_admin, int only_pending,
+			     uint32_t page_size, uint32_t *page_jobid,
+			     List sent_list)
 {
 	char *query = NULL;
 	char *extra = xstrdup(sent_extra);
@@ -392,6 +394,11 @@ static int _cluster_get_jobs(mysql_conn_t *mysql_conn,
 	int rc = SLURM_SUCCESS;
 	int last_id = -1, curr_id = -1;
 	local_cluster_t *curr_cluster = NULL;
+	uint32_t page_after = *page_jobid, page_skip = 0;
+	char *page_query = NULL;
+	bool page_where = false;
+
+	*page_jobid = 0;
 
 	/* This is here to make sure we are looking at only this user
 	 * if this flag is set.  We also include any accounts they may be
@@ -484,26 +491,80 @@ static int _cluster_get_jobs(mysql_conn_t *mysql_conn,
 			xstrcat(extra, " where (t1.time_end=0)");
 	}
 
+	if (page_after) {
+		if (extra)
+			xstrfmtcat(extra, " && (t1.id_job>%u)", page_after);
+		else
+			xstrfmtcat(extra, " where (t1.id_job>%u)", page_after);
+	}
+
 	if (extra) {
 		xstrcat(query, extra);
 		xfree(extra);
+		page_where = true;
 	}
+	if (page_size)
+		page_query = xstrdup(query);
 
 	/* Here we want to order them this way in such a way so it is
 	   easy to look for duplicates, it is also easy to sort the
-	   resized jobs.
+	   resized jobs.  The order must be explicit when paging since
+	   the page boundary is taken from the last row.
 	*/
-	xstrcat(query, " group by id_job, time_submit desc");
+	xstrcat(query, " group by id_job, time_submit desc"
+		" order by t1.id_job, t1.time_submit desc");
+	if (page_size)
+		xstrfmtcat(query, " limit %u", page_size);
 
 	if (debug_flags & DEBUG_FLAG_DB_JOB)
 		DB_DEBUG(mysql_conn->conn, "query\n%s", query);
 	if (!(result = mysql_db_query_ret(mysql_conn, query, 0))) {
 		xfree(query);
+		xfree(page_query);
 		rc = SLURM_ERROR;
 		goto end_it;
 	}
 	xfree(query);
 
+	/*
+	 * A full page may end in the middle of the records of a job, leave
+	 * that job to the next page.  If that job is the only one on this
+	 * page it has more records than fit in a page, so get all of them
+	 * without a limit instead of dropping the rest.
+	 */
+	if (page_size && (mysql_num_rows(result) >= page_size)) {
+		uint32_t first_id;
+
+		row = mysql_fetch_row(result);
+		first_id = slurm_atoul(row[JOB_REQ_JOBID]);
+		mysql_data_seek(result, mysql_num_rows(result) - 1);
+		row = mysql_fetch_row(result);
+		page_skip = slurm_atoul(row[JOB_REQ_JOBID]);
+		mysql_data_seek(result, 0);
+		if (page_skip == first_id) {
+			mysql_free_result(result);
+			query = page_query;
+			page_query = NULL;
+			xstrfmtcat(query, " %s (t1.id_job=%u)"
+				   " group by id_job, time_submit desc"
+				   " order by t1.id_job, t1.time_submit desc",
+				   page_where ? "&&" : "where", first_id);
+			if (debug_flags & DEBUG_FLAG_DB_JOB)
+				DB_DEBUG(mysql_conn->conn, "query\n%s", query);
+			if (!(result = mysql_db_query_ret(
+				      mysql_conn, query, 0))) {
+				xfree(query);
+				rc = SLURM_ERROR;
+				goto end_it;
+			}
+			xfree(query);
+			*page_jobid = first_id;
+			page_skip = 0;
+		} else
+			*page_jobid = page_skip - 1;
+	}
+	xfree(page_query);
+
 
 	/* Here we set up environment to check used nodes of jobs.
 	   Since we store the bitmap of the entire cluster we can use
@@ -528,6 +589,9 @@ static int _cluster_get_jobs(mysql_conn_t *mysql_conn,
 
 		curr_id = slurm_atoul(row[JOB_REQ_JOBID]);
 
+		if (page_skip && (curr_id == page_skip))
+			break;
+
 		if (job_cond && !(job_cond->flags & JOBCOND_FLAG_DUP)
 		    && (curr_id == last_id)
 		    && (slurm_atoul(row[JOB_REQ_STATE]) != JOB_RESIZING))
@@ -1629,6 +1693,8 @@ extern List as_mysql_jobacct_process_get_jobs(mysql_conn_t *mysql_conn,
 	int only_pending = 0;
 	List use_cluster_list = as_mysql_cluster_list;
 	char *cluster_name;
+	uint32_t page_size = 0;
+	bool page_started = true;
 	assoc_mgr_lock_t locks = { NO_LOCK, NO_LOCK, NO_LOCK, NO_LOCK,
 				   READ_LOCK, NO_LOCK, NO_LOCK };
 
@@ -1679,16 +1745,44 @@ extern List as_mysql_jobacct_process_get_jobs(mysql_conn_t *mysql_conn,
 
 	assoc_mgr_lock(&locks);
 
+	/*
+	 * With a page size, return the jobs following page_jobid of
+	 * page_cluster, in the order of the cluster list and then by job id,
+	 * until there are at least page_size of them.
+	 */
+	if (job_cond) {
+		page_size = job_cond->page_size;
+		if (page_size && job_cond->page_cluster)
+			page_started = false;
+	}
+
 	job_list = list_create(slurmdb_destroy_job_rec);
 	itr = list_iterator_create(use_cluster_list);
 	while ((cluster_name = list_next(itr))) {
+		uint32_t page_jobid = 0;
 		int rc;
-		if ((rc = _cluster_get_jobs(mysql_conn, &user, job_cond,
-					    cluster_name, tmp, tmp2, extra,
-					    is_admin, only_pending, job_list))
-		    != SLURM_SUCCESS)
-			error("Problem getting jobs for cluster %s",
-			      cluster_name);
+
+		if (!page_started) {
+			if (xstrcmp(cluster_name, job_cond->page_cluster))
+				continue;
+			page_started = true;
+			page_jobid = job_cond->page_jobid;
+		}
+		do {
+			if ((rc = _cluster_get_jobs(mysql_conn, &user,
+						    job_cond, cluster_name,
+						    tmp, tmp2, extra, is_admin,
+						    only_pending, page_size,
+						    &page_jobid, job_list))
+			    != SLURM_SUCCESS) {
+				error("Problem getting jobs for cluster %s",
+				      cluster_name);
+				break;
+			}
+		} while (page_jobid && (list_count(job_list) < page_size));
+
+		if (page_size && (list_count(job_list) >= page_size))
+			break;
 	}
 	list_iterator_destroy(itr);
 
@@ -43,6 +43,14 @@
 #include "src/common/parse_time.h"
 #include "src/common/slurm_time.h"
 
+/*
+ * When catching up on several hours the jobs are read once for up to
+ * ROLLUP_HOUR_BATCH hours, and the usage rows of those hours are inserted
+ * together in statements of about ROLLUP_INSERT_MAX bytes.
+ */
+#define ROLLUP_HOUR_BATCH 6
+#define ROLLUP_INSERT_MAX (1024 * 1024)
+
 enum {
 	TIME_ALLOC,
 	TIME_DOWN,
@@ -72,6 +80,16 @@ typedef struct {
 	List loc_tres;
 } local_id_usage_t;
 
+/*
+ * A job's tres_alloc string parsed into arrays. The hourly rollup walks the
+ * same job rows once per hour of a batch, so each row is only parsed once.
+ */
+typedef struct {
+	int cnt;		/* entries in the arrays, -1 if not parsed yet */
+	uint32_t *id;
+	uint64_t *count;
+} local_job_tres_t;
+
 typedef struct {
 	time_t end;
 	int id; /*only needed for reservations */
@@ -378,64 +396,109 @@ static void _transfer_loc_tres(List *loc_tres, local_id_usage_t *usage)
 	}
 }
 
-static void _add_tres_time_2_list(List tres_list, char *tres_str,
-				  int type, int seconds, int suspend_seconds,
-				  bool times_count)
+static void _parse_job_tres(local_job_tres_t *job_tres, char *tres_str)
 {
 	char *tmp_str = tres_str;
-	int id;
-	uint64_t time, count;
-	local_tres_usage_t *loc_tres;
-
-	xassert(tres_list);
+	int id, max_cnt = 1;
 
+	job_tres->cnt = 0;
 	if (!tres_str || !tres_str[0])
 		return;
 
-	while (tmp_str) {
-		int loc_seconds = seconds;
+	for (tmp_str = tres_str; *tmp_str; tmp_str++) {
+		if (*tmp_str == ',')
+			max_cnt++;
+	}
+	job_tres->id = xmalloc(sizeof(uint32_t) * max_cnt);
+	job_tres->count = xmalloc(sizeof(uint64_t) * max_cnt);
 
+	tmp_str = tres_str;
+	while (tmp_str && (job_tres->cnt < max_cnt)) {
 		id = atoi(tmp_str);
 		if (id < 1) {
-			error("_add_tres_time_2_list: no id "
+			error("_parse_job_tres: no id "
 			      "found at %s", tmp_str);
 			break;
 		}
 		if (!(tmp_str = strchr(tmp_str, '='))) {
-			error("_add_tres_time_2_list: no value found for "
+			error("_parse_job_tres: no value found for "
 			      "id %d '%s'", id, tres_str);
 			xassert(0);
 			break;
 		}
+		job_tres->id[job_tres->cnt] = id;
+		job_tres->count[job_tres->cnt] = slurm_atoull(++tmp_str);
+		job_tres->cnt++;
+
+		if (!(tmp_str = strchr(tmp_str, ',')))
+			break;
+		tmp_str++;
+	}
+}
+
+static void _free_job_tres(local_job_tres_t *job_tres, int cnt)
+{
+	int i;
+
+	if (!job_tres)
+		return;
+
+	for (i = 0; i < cnt; i++) {
+		xfree(job_tres[i].id);
+		xfree(job_tres[i].count);
+	}
+	xfree(job_tres);
+}
+
+static void _add_job_tres_time_2_list(List tres_list,
+				      local_job_tres_t *job_tres,
+				      int type, int seconds,
+				      int suspend_seconds, bool times_count)
+{
+	int i;
+	uint64_t time;
+	local_tres_usage_t *loc_tres;
+
+	xassert(tres_list);
+
+	for (i = 0; i < job_tres->cnt; i++) {
+		int loc_seconds = seconds;
 
 		/* Take away suspended time from TRES that are idle when the
 		 * job was suspended, currently only CPU's fill that bill.
 		 */
-		if (suspend_seconds && (id == TRES_CPU)) {
+		if (suspend_seconds && (job_tres->id[i] == TRES_CPU)) {
 			loc_seconds -= suspend_seconds;
 			if (loc_seconds < 1)
 				loc_seconds = 0;
 		}
 
-		time = count = slurm_atoull(++tmp_str);
+		time = job_tres->count[i];
 		/* ENERGY is already totalled for the entire job so don't
 		 * multiple with time.
 		 */
-		if (id != TRES_ENERGY)
+		if (job_tres->id[i] != TRES_ENERGY)
 			time *= loc_seconds;
 
-		loc_tres = _add_time_tres(tres_list, type, id,
+		loc_tres = _add_time_tres(tres_list, type, job_tres->id[i],
 					  time, times_count);
 
 		if (loc_tres && !loc_tres->count)
-			loc_tres->count = count;
-
-		if (!(tmp_str = strchr(tmp_str, ',')))
-			break;
-		tmp_str++;
+			loc_tres->count = job_tres->count[i];
 	}
+}
 
-	return;
+static void _add_tres_time_2_list(List tres_list, char *tres_str,
+				  int type, int seconds, int suspend_seconds,
+				  bool times_count)
+{
+	local_job_tres_t job_tres = { 0 };
+
+	_parse_job_tres(&job_tres, tres_str);
+	_add_job_tres_time_2_list(tres_list, &job_tres, type, seconds,
+				  suspend_seconds, times_count);
+	xfree(job_tres.id);
+	xfree(job_tres.count);
 }
 
 static int _process_purge(mysql_conn_t *mysql_conn,
@@ -744,7 +807,7 @@ static void _create_id_usage_insert(char *cluster_name, int type,
 		return;
 	}
 
-	first = 1;
+	first = (*query == NULL);
 	itr = list_iterator_create(id_usage->loc_tres);
 	while ((loc_tres = list_next(itr))) {
 		if (!first) {
@@ -766,9 +829,29 @@ static void _create_id_usage_insert(char *cluster_name, int type,
 		}
 	}
 	list_iterator_destroy(itr);
+}
+
+/*
+ * Send the rows collected by _create_id_usage_insert() as one multi-row
+ * insert.
+ */
+static int _flush_id_usage_insert(mysql_conn_t *mysql_conn, time_t now,
+				  char **query)
+{
+	int rc;
+
+	if (!*query)
+		return SLURM_SUCCESS;
+
 	xstrfmtcat(*query,
 		   " on duplicate key update mod_time=%ld, "
 		   "alloc_secs=VALUES(alloc_secs);", now);
+	if (debug_flags & DEBUG_FLAG_DB_USAGE)
+		DB_DEBUG(mysql_conn->conn, "query\n%s", *query);
+	rc = mysql_db_query(mysql_conn, *query);
+	xfree(*query);
+
+	return rc;
 }
 
 static local_cluster_usage_t *_setup_cluster_usage(mysql_conn_t *mysql_conn,
@@ -956,9 +1039,12 @@ extern int as_mysql_hourly_rollup(mysql_conn_t *mysql_conn,
 	time_t now = time(NULL);
 	time_t curr_start = start;
 	time_t curr_end = curr_start + add_sec;
-	char *query = NULL;
-	MYSQL_RES *result = NULL;
+	char *query = NULL, *assoc_query = NULL, *wckey_query = NULL;
+	MYSQL_RES *result = NULL, *job_result = NULL;
 	MYSQL_ROW row;
+	time_t job_batch_end = 0;
+	local_job_tres_t *job_tres = NULL;
+	int job_rows = 0, job_row;
 	ListIterator a_itr = NULL;
 	ListIterator c_itr = NULL;
 	ListIterator w_itr = NULL;
@@ -1206,28 +1292,52 @@ extern int as_mysql_hourly_rollup(mysql_conn_t *mysql_conn,
 		}
 		mysql_free_result(result);
 
-		/* now get the jobs during this time only  */
-		query = xstrdup_printf("select %s from \"%s_%s\" as job "
-				       "where (job.time_eligible && "
-				       "job.time_eligible < %ld && "
-				       "(job.time_end >= %ld || "
-				       "job.time_end = 0)) "
-				       "group by job.job_db_inx "
-				       "order by job.id_assoc, "
-				       "job.time_eligible",
-				       job_str, cluster_name, job_table,
-				       curr_end, curr_start);
+		/*
+		 * Now get the jobs during this time only. When more than
+		 * one hour is rolled up, get the jobs for the next few hours
+		 * in one go and walk the stored rows again for each hour.
+		 */
+		if (curr_end > job_batch_end) {
+			int hours = (end - curr_start + add_sec - 1) / add_sec;
+
+			if (job_result)
+				mysql_free_result(job_result);
+			_free_job_tres(job_tres, job_rows);
+			job_tres = NULL;
+			job_rows = 0;
+			job_batch_end = curr_start +
+				(MIN(hours, ROLLUP_HOUR_BATCH) * add_sec);
+			query = xstrdup_printf(
+				"select %s from \"%s_%s\" as job "
+				"where (job.time_eligible && "
+				"job.time_eligible < %ld && "
+				"(job.time_end >= %ld || "
+				"job.time_end = 0)) "
+				"group by job.job_db_inx "
+				"order by job.id_assoc, "
+				"job.time_eligible",
+				job_str, cluster_name, job_table,
+				job_batch_end, curr_start);
 
-		if (debug_flags & DEBUG_FLAG_DB_USAGE)
-			DB_DEBUG(mysql_conn->conn, "query\n%s", query);
-		if (!(result = mysql_db_query_ret(
-			      mysql_conn, query, 0))) {
-			rc = SLURM_ERROR;
-			goto end_it;
-		}
-		xfree(query);
+			if (debug_flags & DEBUG_FLAG_DB_USAGE)
+				DB_DEBUG(mysql_conn->conn, "query\n%s", query);
+			if (!(job_result = mysql_db_query_ret(
+				      mysql_conn, query, 0))) {
+				rc = SLURM_ERROR;
+				goto end_it;
+			}
+			xfree(query);
 
-		while ((row = mysql_fetch_row(result))) {
+			job_rows = mysql_num_rows(job_result);
+			job_tres = xmalloc(sizeof(local_job_tres_t) * job_rows);
+			for (i = 0; i < job_rows; i++)
+				job_tres[i].cnt = -1;
+		} else
+			mysql_data_seek(job_result, 0);
+
+		job_row = 0;
+		while ((row = mysql_fetch_row(job_result))) {
+			local_job_tres_t *row_tres = &job_tres[job_row++];
 			//uint32_t job_id = slurm_atoul(row[JOB_REQ_JOBID]);
 			uint32_t assoc_id = slurm_atoul(row[JOB_REQ_ASSOCID]);
 			uint32_t wckey_id = slurm_atoul(row[JOB_REQ_WCKEYID]);
@@ -1242,6 +1352,11 @@ extern int as_mysql_hourly_rollup(mysql_conn_t *mysql_conn,
 			int loc_seconds = 0;
 			int seconds = 0, suspend_seconds = 0;
 
+			/* skip jobs of the batch not eligible in this hour */
+			if ((row_eligible >= curr_end) ||
+			    (row_end && (row_end < curr_start)))
+				continue;
+
 			if (row_start && (row_start < curr_start))
 				row_start = curr_start;
 
@@ -1277,7 +1392,6 @@ extern int as_mysql_hourly_rollup(mysql_conn_t *mysql_conn,
 					      mysql_conn,
 					      query, 0))) {
 					rc = SLURM_ERROR;
-					mysql_free_result(result);
 					goto end_it;
 				}
 				xfree(query);
@@ -1345,14 +1459,16 @@ extern int as_mysql_hourly_rollup(mysql_conn_t *mysql_conn,
 			 */
 			loc_tres = list_create(_destroy_local_tres_usage);
 
-			_add_tres_time_2_list(loc_tres, row[JOB_REQ_TRES],
-					      TIME_ALLOC, seconds,
-					      suspend_seconds, 0);
+			if (row_tres->cnt == -1)
+				_parse_job_tres(row_tres, row[JOB_REQ_TRES]);
+			_add_job_tres_time_2_list(loc_tres, row_tres,
+						  TIME_ALLOC, seconds,
+						  suspend_seconds, 0);
 			if (w_usage)
-				_add_tres_time_2_list(w_usage->loc_tres,
-						      row[JOB_REQ_TRES],
-						      TIME_ALLOC, seconds,
-						      suspend_seconds, 0);
+				_add_job_tres_time_2_list(w_usage->loc_tres,
+							  row_tres,
+							  TIME_ALLOC, seconds,
+							  suspend_seconds, 0);
 
 			/*
 			 * Now figure out there was a disconnected
@@ -1512,7 +1628,6 @@ extern int as_mysql_hourly_rollup(mysql_conn_t *mysql_conn,
 				}
 			}
 		}
-		mysql_free_result(result);
 
 		/* now figure out how much more to add to the
 		   associations that could had run in the reservation
@@ -1623,38 +1738,33 @@ extern int as_mysql_hourly_rollup(mysql_conn_t *mysql_conn,
 		while ((a_usage = list_next(a_itr)))
 			_create_id_usage_insert(cluster_name, ASSOC_TABLES,
 						curr_start, now,
-						a_usage, &query);
-		if (query) {
-			if (debug_flags & DEBUG_FLAG_DB_USAGE)
-				DB_DEBUG(mysql_conn->conn, "query\n%s", query);
-			rc = mysql_db_query(mysql_conn, query);
-			xfree(query);
-			if (rc != SLURM_SUCCESS) {
-				error("Couldn't add assoc hour rollup");
-				goto end_it;
-			}
+						a_usage, &assoc_query);
+		if (((curr_end >= job_batch_end) ||
+		     (assoc_query &&
+		      (strlen(assoc_query) > ROLLUP_INSERT_MAX))) &&
+		    (rc = _flush_id_usage_insert(mysql_conn, now,
+						 &assoc_query))) {
+			error("Couldn't add assoc hour rollup");
+			goto end_it;
 		}
 
-		if (!track_wckey)
-			goto end_loop;
-
-		list_iterator_reset(w_itr);
-		while ((w_usage = list_next(w_itr)))
-			_create_id_usage_insert(cluster_name, WCKEY_TABLES,
-						curr_start, now,
-						w_usage, &query);
-		if (query) {
-			if (debug_flags & DEBUG_FLAG_DB_USAGE)
-				DB_DEBUG(mysql_conn->conn, "query\n%s", query);
-			rc = mysql_db_query(mysql_conn, query);
-			xfree(query);
-			if (rc != SLURM_SUCCESS) {
-				error("Couldn't add wckey hour rollup");
-				goto end_it;
-			}
+		if (track_wckey) {
+			list_iterator_reset(w_itr);
+			while ((w_usage = list_next(w_itr)))
+				_create_id_usage_insert(cluster_name,
+							WCKEY_TABLES,
+							curr_start, now,
+							w_usage, &wckey_query);
+		}
+		if (((curr_end >= job_batch_end) ||
+		     (wckey_query &&
+		      (strlen(wckey_query) > ROLLUP_INSERT_MAX))) &&
+		    (rc = _flush_id_usage_insert(mysql_conn, now,
+						 &wckey_query))) {
+			error("Couldn't add wckey hour rollup");
+			goto end_it;
 		}
 
-	end_loop:
 		_destroy_local_cluster_usage(c_usage);
 
 		c_usage     = NULL;
@@ -1670,7 +1780,12 @@ extern int as_mysql_hourly_rollup(mysql_conn_t *mysql_conn,
 		curr_end = curr_start + add_sec;
 	}
 end_it:
+	if (job_result)
+		mysql_free_result(job_result);
+	_free_job_tres(job_tres, job_rows);
 	xfree(query);
+	xfree(assoc_query);
+	xfree(wckey_query);
 	xfree(suspend_str);
 	xfree(job_str);
 	xfree(resv_str);
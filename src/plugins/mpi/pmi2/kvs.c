@@ -35,21 +35,29 @@
  *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA.
 \*****************************************************************************/
 
+#include <pthread.h>
 #include <stdlib.h>
 #include <unistd.h>
 
+#include "src/common/slurm_xlator.h"
+#include "src/common/hostlist.h"
+#include "src/common/list.h"
+#include "src/common/timers.h"
+
 #include "kvs.h"
 #include "setup.h"
 #include "tree.h"
 #include "pmi.h"
 
 #define MAX_RETRIES 5
+#define SHARD_SEND_THREADS 16	/* concurrent sends to home nodes */
 
 /* for fence */
 int tasks_to_wait = 0;
 int children_to_wait = 0;
 int kvs_seq = 1; /* starting from 1 */
 int waiting_kvs_resp = 0;
+int kvs_direct = 0;
 
 
 /* bucket of key-value pairs */
@@ -68,6 +76,27 @@ static int temp_kvs_size = 0;
 
 static int no_dup_keys = 0;
 
+/* fence instrumentation */
+static struct timeval fence_start;
+static uint32_t fence_shard_bytes = 0;
+
+/*
+ * Direct mode: every key has a home node chosen by hashing the key. Puts
+ * are pushed to the home node at fence time instead of being merged up the
+ * tree, and gets that miss locally are fetched from the home node.
+ */
+typedef struct kvs_fetch {
+	char *key;
+	int fd;
+	kvs_get_resp_f resp_func;
+} kvs_fetch_t;
+
+static hostlist_t kvs_hl = NULL;	/* maps nodeid to node name */
+static Buf *shard_bufs = NULL;		/* pending puts, per home node */
+static int shard_cnt = 0;		/* number of non-NULL shard_bufs */
+static kvs_bucket_t *cache_hash = NULL;	/* values fetched from home nodes */
+static List pending_fetches = NULL;	/* gets waiting for a home node */
+
 #define TASKS_PER_BUCKET 8
 #define TEMP_KVS_SIZE_INC 2048
 
@@ -90,6 +119,267 @@ _hash(char *key)
 	return hash;
 }
 
+/*
+ * FNV-1a. Kept independent of _hash() so that the keys homed on one node
+ * still spread over all of its local buckets.
+ */
+inline static uint32_t
+_home_nodeid(char *key)
+{
+	uint32_t hash = 2166136261U;
+
+	for ( ; *key; key++) {
+		hash ^= (uint8_t) *key;
+		hash *= 16777619U;
+	}
+	return hash % job_info.nnodes;
+}
+
+static char *
+_bucket_get(kvs_bucket_t *table, char *key)
+{
+	kvs_bucket_t *bucket = &table[HASH(key)];
+	int i;
+
+	for (i = 0; i < bucket->count; i ++) {
+		if (! xstrcmp(key, bucket->pairs[KEY_INDEX(i)]))
+			return bucket->pairs[VAL_INDEX(i)];
+	}
+	return NULL;
+}
+
+static void
+_bucket_put(kvs_bucket_t *table, char *key, char *val, int no_dup)
+{
+	kvs_bucket_t *bucket = &table[HASH(key)];
+	int i;
+
+	if (! no_dup) {
+		for (i = 0; i < bucket->count; i ++) {
+			if (! xstrcmp(key, bucket->pairs[KEY_INDEX(i)])) {
+				/* replace the k-v pair */
+				xfree(bucket->pairs[VAL_INDEX(i)]);
+				bucket->pairs[VAL_INDEX(i)] = xstrdup(val);
+				return;
+			}
+		}
+	}
+	if (bucket->count * 2 >= bucket->size) {
+		bucket->size += (TASKS_PER_BUCKET * 2);
+		xrealloc(bucket->pairs, bucket->size * sizeof(char *));
+	}
+	/* add the k-v pair */
+	i = bucket->count;
+	bucket->pairs[KEY_INDEX(i)] = xstrdup(key);
+	bucket->pairs[VAL_INDEX(i)] = xstrdup(val);
+	bucket->count ++;
+}
+
+static void
+_bucket_clear(kvs_bucket_t *table)
+{
+	kvs_bucket_t *bucket;
+	int i, j;
+
+	for (i = 0; i < hash_size; i ++){
+		bucket = &table[i];
+		for (j = 0; j < bucket->count; j ++) {
+			xfree (bucket->pairs[KEY_INDEX(j)]);
+			xfree (bucket->pairs[VAL_INDEX(j)]);
+		}
+		bucket->count = 0;
+	}
+}
+
+static void
+_fetch_free(void *x)
+{
+	kvs_fetch_t *fetch = (kvs_fetch_t *) x;
+
+	if (fetch) {
+		xfree(fetch->key);
+		xfree(fetch);
+	}
+}
+
+static int
+_fetch_match_key(void *x, void *key)
+{
+	kvs_fetch_t *fetch = (kvs_fetch_t *) x;
+
+	return (xstrcmp(fetch->key, (char *) key) == 0);
+}
+
+/* try once to send a tree message to the stepd of the given node */
+static int
+_forward_to_nodeid(uint32_t nodeid, Buf buf)
+{
+	int rc;
+	char *host, *nodelist;
+
+	host = hostlist_nth(kvs_hl, nodeid); /* strdup-ed */
+	nodelist = xstrdup(host);
+	rc = slurm_forward_data(&nodelist, tree_sock_addr,
+				get_buf_offset(buf), get_buf_data(buf));
+	xfree(nodelist);
+	free(host);
+
+	return rc;
+}
+
+/* send a tree message to the stepd of the given node */
+static int
+_send_to_nodeid(uint32_t nodeid, Buf buf)
+{
+	int rc = SLURM_ERROR, retry = 0;
+	unsigned int delay = 1;
+
+	while (1) {
+		rc = _forward_to_nodeid(nodeid, buf);
+		if (rc == SLURM_SUCCESS)
+			break;
+		if (++retry >= MAX_RETRIES) {
+			error("mpi/pmi2: failed to send kvs message to node "
+			      "%u", nodeid);
+			break;
+		}
+		/* wait, in case the remote stepd is not ready */
+		sleep(delay);
+		delay *= 2;
+	}
+
+	return rc;
+}
+
+/* queue a put for its home node, which receives it at the next fence */
+static int
+_shard_add(char *key, char *val)
+{
+	uint32_t home = _home_nodeid(key);
+
+	if (home == job_info.nodeid)
+		return kvs_put(key, val);
+
+	if (!shard_bufs[home]) {
+		shard_bufs[home] = init_buf(1024);
+		pack16(TREE_CMD_KVS_SHARD, shard_bufs[home]);
+		pack32(job_info.nodeid, shard_bufs[home]);
+		shard_cnt++;
+	}
+	packstr(key, shard_bufs[home]);
+	packstr(val, shard_bufs[home]);
+
+	return SLURM_SUCCESS;
+}
+
+typedef struct {
+	pthread_mutex_t mutex;
+	uint32_t *nodeids;	/* home nodes to send to this round */
+	int cnt;
+	int next;		/* next entry of nodeids to send */
+	int fail_cnt;		/* failed sends, moved to the front */
+} shard_send_t;
+
+/* send thread: take home nodes off the list until it is empty */
+static void *
+_shard_send_thread(void *arg)
+{
+	shard_send_t *send = (shard_send_t *) arg;
+	uint32_t nodeid;
+
+	while (1) {
+		slurm_mutex_lock(&send->mutex);
+		if (send->next >= send->cnt) {
+			slurm_mutex_unlock(&send->mutex);
+			break;
+		}
+		nodeid = send->nodeids[send->next++];
+		slurm_mutex_unlock(&send->mutex);
+
+		if (_forward_to_nodeid(nodeid, shard_bufs[nodeid]) ==
+		    SLURM_SUCCESS)
+			continue;
+
+		slurm_mutex_lock(&send->mutex);
+		/* fail_cnt < next, so this never overwrites an unsent one */
+		send->nodeids[send->fail_cnt++] = nodeid;
+		slurm_mutex_unlock(&send->mutex);
+	}
+
+	return NULL;
+}
+
+/*
+ * Push the queued puts to their home nodes. This must complete before the
+ * fence is reported upwards: once srun releases the fence every home node
+ * must have all the pairs it is responsible for.
+ *
+ * Up to SHARD_SEND_THREADS sends are in flight at once, so one slow stepd
+ * only holds up its own shard. Failed sends are retried together after a
+ * backoff, in case the remote stepds are not ready yet.
+ */
+static int
+_shard_flush(void)
+{
+	shard_send_t send;
+	pthread_t threads[SHARD_SEND_THREADS];
+	int i, thread_cnt, retry = 0, rc = SLURM_SUCCESS;
+	unsigned int delay = 1;
+
+	fence_shard_bytes = 0;
+	if (!shard_cnt)
+		return SLURM_SUCCESS;
+
+	memset(&send, 0, sizeof(send));
+	slurm_mutex_init(&send.mutex);
+	send.nodeids = xmalloc(shard_cnt * sizeof(uint32_t));
+	for (i = 0; i < job_info.nnodes; i++) {
+		if (!shard_bufs[i])
+			continue;
+		fence_shard_bytes += get_buf_offset(shard_bufs[i]);
+		send.nodeids[send.cnt++] = i;
+	}
+
+	while (1) {
+		send.next = 0;
+		send.fail_cnt = 0;
+		thread_cnt = MIN(send.cnt, SHARD_SEND_THREADS);
+		for (i = 0; i < thread_cnt; i++)
+			slurm_thread_create(&threads[i], _shard_send_thread,
+					    &send);
+		for (i = 0; i < thread_cnt; i++)
+			pthread_join(threads[i], NULL);
+
+		if (!send.fail_cnt)
+			break;
+		if (++retry >= MAX_RETRIES) {
+			for (i = 0; i < send.fail_cnt; i++)
+				error("mpi/pmi2: failed to send kvs shard to "
+				      "node %u", send.nodeids[i]);
+			rc = SLURM_ERROR;
+			break;
+		}
+		debug("mpi/pmi2: %d kvs shards not sent, retrying",
+		      send.fail_cnt);
+		/* wait, in case the remote stepds are not ready */
+		sleep(delay);
+		delay *= 2;
+		send.cnt = send.fail_cnt;
+	}
+
+	slurm_mutex_destroy(&send.mutex);
+	xfree(send.nodeids);
+	for (i = 0; i < job_info.nnodes; i++) {
+		if (!shard_bufs[i])
+			continue;
+		free_buf(shard_bufs[i]);
+		shard_bufs[i] = NULL;
+	}
+	shard_cnt = 0;
+
+	return rc;
+}
+
 extern int
 temp_kvs_init(void)
 {
@@ -147,6 +437,9 @@ temp_kvs_add(char *key, char *val)
 	if ( key == NULL || val == NULL )
 		return SLURM_SUCCESS;
 
+	if (kvs_direct)
+		return _shard_add(key, val);
+
 	buf = init_buf(PMI2_MAX_KEYLEN + PMI2_MAX_VALLEN + 2 * sizeof(uint32_t));
 	packstr(key, buf);
 	packstr(val, buf);
@@ -191,6 +484,21 @@ temp_kvs_send(void)
 	int rc = SLURM_ERROR, retry = 0;
 	unsigned int delay = 1;
 	char *nodelist = NULL;
+	struct timeval now;
+	char tv_str[20] = "";
+	long delta_t;
+
+	if (kvs_direct && _shard_flush() != SLURM_SUCCESS)
+		return SLURM_ERROR;
+
+	if (!fence_start.tv_sec)
+		gettimeofday(&fence_start, NULL);
+	gettimeofday(&now, NULL);
+	slurm_diff_tv_str(&fence_start, &now, tv_str, sizeof(tv_str),
+			  NULL, 0, &delta_t);
+	debug("mpi/pmi2: kvs fence %d gathered in %s, sending %d bytes "
+	      "(%u bytes to home nodes)", kvs_seq, tv_str, temp_kvs_cnt,
+	      fence_shard_bytes);
 
 	if (!in_stepd())	/* srun */
 		nodelist = xstrdup(job_info.step_nodelist);
@@ -223,6 +531,10 @@ temp_kvs_send(void)
 		delay *= 2;
 	}
 	temp_kvs_init();	/* clear old temp kvs */
+	if (in_stepd())		/* measure the round trip from here */
+		gettimeofday(&fence_start, NULL);
+	else
+		memset(&fence_start, 0, sizeof(fence_start));
 
 	xfree(nodelist);
 
@@ -231,6 +543,35 @@ temp_kvs_send(void)
 
 /**************************************************************/
 
+/* called when the first member of a fence arrives */
+extern void
+kvs_fence_begin(void)
+{
+	gettimeofday(&fence_start, NULL);
+}
+
+/* called in stepd when the fence response has been received */
+extern void
+kvs_fence_done(uint32_t resp_bytes)
+{
+	struct timeval now;
+	char tv_str[20] = "";
+	long delta_t;
+
+	gettimeofday(&now, NULL);
+	slurm_diff_tv_str(&fence_start, &now, tv_str, sizeof(tv_str),
+			  NULL, 0, &delta_t);
+	debug("mpi/pmi2: kvs fence %d completed in %s, received %u bytes",
+	      kvs_seq - 1, tv_str, resp_bytes);
+	memset(&fence_start, 0, sizeof(fence_start));
+
+	/* values fetched during the last epoch may have been replaced */
+	if (kvs_direct)
+		_bucket_clear(cache_hash);
+}
+
+/**************************************************************/
+
 extern int
 kvs_init(void)
 {
@@ -243,6 +584,15 @@ kvs_init(void)
 	if (getenv(PMI2_KVS_NO_DUP_KEYS_ENV))
 		no_dup_keys = 1;
 
+	if (kvs_direct) {
+		debug("mpi/pmi2: using direct kvs, keys sharded over %u nodes",
+		      job_info.nnodes);
+		kvs_hl = hostlist_create(job_info.step_nodelist);
+		shard_bufs = xmalloc(job_info.nnodes * sizeof(Buf));
+		cache_hash = xmalloc(hash_size * sizeof(kvs_bucket_t));
+		pending_fetches = list_create(_fetch_free);
+	}
+
 	return SLURM_SUCCESS;
 }
 
@@ -252,21 +602,13 @@ kvs_init(void)
 extern char *
 kvs_get(char *key)
 {
-	kvs_bucket_t *bucket;
-	char *val = NULL;
-	int i;
+	char *val;
 
 	debug3("mpi/pmi2: in kvs_get, key=%s", key);
 
-	bucket = &kvs_hash[HASH(key)];
-	if (bucket->count > 0) {
-		for(i = 0; i < bucket->count; i ++) {
-			if (! xstrcmp(key, bucket->pairs[KEY_INDEX(i)])) {
-				val = bucket->pairs[VAL_INDEX(i)];
-				break;
-			}
-		}
-	}
+	val = _bucket_get(kvs_hash, key);
+	if (!val && kvs_direct)
+		val = _bucket_get(cache_hash, key);
 
 	debug3("mpi/pmi2: out kvs_get, val=%s", val);
 
@@ -276,33 +618,9 @@ kvs_get(char *key)
 extern int
 kvs_put(char *key, char *val)
 {
-	kvs_bucket_t *bucket;
-	int i;
-
 	debug3("mpi/pmi2: in kvs_put");
 
-	bucket = &kvs_hash[HASH(key)];
-
-	if (! no_dup_keys) {
-		for (i = 0; i < bucket->count; i ++) {
-			if (! xstrcmp(key, bucket->pairs[KEY_INDEX(i)])) {
-				/* replace the k-v pair */
-				xfree(bucket->pairs[VAL_INDEX(i)]);
-				bucket->pairs[VAL_INDEX(i)] = xstrdup(val);
-				debug("mpi/pmi2: put kvs %s=%s", key, val);
-				return SLURM_SUCCESS;
-			}
-		}
-	}
-	if (bucket->count * 2 >= bucket->size) {
-		bucket->size += (TASKS_PER_BUCKET * 2);
-		xrealloc(bucket->pairs, bucket->size * sizeof(char *));
-	}
-	/* add the k-v pair */
-	i = bucket->count;
-	bucket->pairs[KEY_INDEX(i)] = xstrdup(key);
-	bucket->pairs[VAL_INDEX(i)] = xstrdup(val);
-	bucket->count ++;
+	_bucket_put(kvs_hash, key, val, no_dup_keys);
 
 	debug3("mpi/pmi2: put kvs %s=%s", key, val);
 	return SLURM_SUCCESS;
@@ -311,17 +629,104 @@ kvs_put(char *key, char *val)
 extern int
 kvs_clear(void)
 {
-	kvs_bucket_t *bucket;
-	int i, j;
+	_bucket_clear(kvs_hash);
+	xfree(kvs_hash);
 
-	for (i = 0; i < hash_size; i ++){
-		bucket = &kvs_hash[i];
-		for (j = 0; j < bucket->count; j ++) {
-			xfree (bucket->pairs[KEY_INDEX(j)]);
-			xfree (bucket->pairs[VAL_INDEX(j)]);
-		}
+	if (kvs_direct) {
+		_bucket_clear(cache_hash);
+		xfree(cache_hash);
+		FREE_NULL_LIST(pending_fetches);
+		FREE_NULL_HOSTLIST(kvs_hl);
+		xfree(shard_bufs);
 	}
-	xfree(kvs_hash);
+
+	return SLURM_SUCCESS;
+}
+
+/**************************************************************/
+
+/*
+ * Ask the home node of key for its value. resp_func is called with the
+ * value (NULL if not found) once the home node answers.
+ * RET SLURM_SUCCESS if the reply is deferred, SLURM_ERROR if the key is not
+ *     fetchable and the caller should answer "not found" right away
+ */
+extern int
+kvs_direct_fetch(char *key, int fd, kvs_get_resp_f resp_func)
+{
+	kvs_fetch_t *fetch;
+	uint32_t home;
+	bool outstanding;
+	Buf buf;
+	int rc;
+
+	if (!kvs_direct)
+		return SLURM_ERROR;
+	home = _home_nodeid(key);
+	if (home == job_info.nodeid)	/* we are authoritative */
+		return SLURM_ERROR;
+
+	/* local tasks asking for the same key share one request */
+	outstanding = list_find_first(pending_fetches, _fetch_match_key, key);
+
+	fetch = xmalloc(sizeof(kvs_fetch_t));
+	fetch->key = xstrdup(key);
+	fetch->fd = fd;
+	fetch->resp_func = resp_func;
+	list_append(pending_fetches, fetch);
+	if (outstanding)
+		return SLURM_SUCCESS;
+
+	debug3("mpi/pmi2: fetching kvs %s from node %u", key, home);
+	buf = init_buf(1024);
+	pack16(TREE_CMD_KVS_GET, buf);
+	pack32(job_info.nodeid, buf);
+	packstr(key, buf);
+	rc = _send_to_nodeid(home, buf);
+	free_buf(buf);
+	if (rc != SLURM_SUCCESS)
+		list_delete_all(pending_fetches, _fetch_match_key, key);
+
+	return rc;
+}
+
+/* answer a fetch from another node, called on the home node of key */
+extern int
+kvs_direct_serve(uint32_t from_nodeid, char *key)
+{
+	Buf buf;
+	int rc;
+
+	buf = init_buf(1024);
+	pack16(TREE_CMD_KVS_GET_RESP, buf);
+	packstr(key, buf);
+	packstr(_bucket_get(kvs_hash, key), buf);
+	rc = _send_to_nodeid(from_nodeid, buf);
+	free_buf(buf);
+
+	return rc;
+}
+
+/* a home node answered a fetch, reply to the waiting tasks */
+extern int
+kvs_direct_deliver(char *key, char *val)
+{
+	ListIterator itr;
+	kvs_fetch_t *fetch;
+
+	if (!kvs_direct)
+		return SLURM_ERROR;
+	if (val)
+		_bucket_put(cache_hash, key, val, 0);
+
+	itr = list_iterator_create(pending_fetches);
+	while ((fetch = list_next(itr))) {
+		if (xstrcmp(fetch->key, key))
+			continue;
+		(void) (fetch->resp_func)(fetch->fd, val);
+		list_delete_item(itr);
+	}
+	list_iterator_destroy(itr);
 
 	return SLURM_SUCCESS;
 }
@@ -48,6 +48,10 @@ extern int tasks_to_wait;
 extern int children_to_wait;
 extern int kvs_seq;
 extern int waiting_kvs_resp;
+extern int kvs_direct;
+
+/* sends the response of a deferred get to the task on fd */
+typedef int (*kvs_get_resp_f) (int fd, char *val);
 
 extern int   temp_kvs_init(void);
 extern int   temp_kvs_add(char *key, char *val);
@@ -59,5 +63,12 @@ extern char *kvs_get(char *key);
 extern int   kvs_put(char *key, char *val);
 extern int   kvs_clear(void);
 
+extern void  kvs_fence_begin(void);
+extern void  kvs_fence_done(uint32_t resp_bytes);
+
+extern int   kvs_direct_fetch(char *key, int fd, kvs_get_resp_f resp_func);
+extern int   kvs_direct_serve(uint32_t from_nodeid, char *key);
+extern int   kvs_direct_deliver(char *key, char *val);
+
 
 #endif	/* _KVS_H */
@@ -232,6 +232,7 @@
 #define PMI2_PREPUT_CNT_ENV     "SLURM_PMI2_PREPUT_COUNT"
 #define PMI2_PPKEY_ENV          "SLURM_PMI2_PPKEY"
 #define PMI2_PPVAL_ENV          "SLURM_PMI2_PPVAL"
+#define PMI2_KVS_DIRECT_ENV     "SLURM_PMI2_KVS_DIRECT"
 #define SLURM_STEP_RESV_PORTS   "SLURM_STEP_RESV_PORTS"
 #define PMIX_RING_TREE_WIDTH_ENV "SLURM_PMIX_RING_WIDTH"
 /* old PMIv1 envs */
@@ -177,6 +177,7 @@ _handle_barrier_in(int fd, int lrank, client_req_t *req)
 	if (tasks_to_wait == 0 && children_to_wait == 0) {
 		tasks_to_wait = job_info.ltasks;
 		children_to_wait = tree_info.num_children;
+		kvs_fence_begin();
 	}
 	tasks_to_wait --;
 
@@ -299,22 +300,11 @@ _handle_put(int fd, int lrank, client_req_t *req)
 }
 
 static int
-_handle_get(int fd, int lrank, client_req_t *req)
+_send_get_resp(int fd, char *val)
 {
 	int rc;
 	client_resp_t *resp;
-	char *kvsname = NULL, *key = NULL, *val = NULL;
 
-	debug3("mpi/pmi2: in _handle_get");
-
-	client_req_parse_body(req);
-	client_req_get_str(req, KVSNAME_KEY, &kvsname); /* not used */
-	client_req_get_str(req, KEY_KEY, &key);
-	xfree(kvsname);
-	
-	val = kvs_get(key);
-	xfree(key);
-	
 	resp = client_resp_new();
 	if (val != NULL) {
 		client_resp_append(resp, CMD_KEY"="GETRESULT_CMD" "
@@ -326,6 +316,32 @@ _handle_get(int fd, int lrank, client_req_t *req)
 	rc = client_resp_send(resp, fd);
 	client_resp_free(resp);
 
+	return rc;
+}
+
+static int
+_handle_get(int fd, int lrank, client_req_t *req)
+{
+	int rc;
+	char *kvsname = NULL, *key = NULL, *val = NULL;
+
+	debug3("mpi/pmi2: in _handle_get");
+
+	client_req_parse_body(req);
+	client_req_get_str(req, KVSNAME_KEY, &kvsname); /* not used */
+	client_req_get_str(req, KEY_KEY, &key);
+	xfree(kvsname);
+
+	val = kvs_get(key);
+	if (!val && (kvs_direct_fetch(key, fd, _send_get_resp) ==
+		     SLURM_SUCCESS)) {
+		/* answered when the home node of the key responds */
+		rc = SLURM_SUCCESS;
+	} else {
+		rc = _send_get_resp(fd, val);
+	}
+	xfree(key);
+
 	debug3("mpi/pmi2: out _handle_get");
 	return rc;
 }
@@ -292,6 +292,7 @@ _handle_kvs_fence(int fd, int lrank, client_req_t *req)
 	if (tasks_to_wait == 0 && children_to_wait == 0) {
 		tasks_to_wait = job_info.ltasks;
 		children_to_wait = tree_info.num_children;
+		kvs_fence_begin();
 	}
 	tasks_to_wait --;
 
@@ -318,19 +319,10 @@ _handle_kvs_fence(int fd, int lrank, client_req_t *req)
 
 
 static int
-_handle_kvs_get(int fd, int lrank, client_req_t *req)
+_send_kvs_get_resp(int fd, char *val)
 {
 	int rc;
 	client_resp_t *resp;
-	char *key = NULL, *val;
-
-	debug3("mpi/pmi2: in _handle_kvs_get");
-
-	client_req_parse_body(req);
-	client_req_get_str(req, KEY_KEY, &key);
-
-	val = kvs_get(key);
-	xfree(key);
 
 	resp = client_resp_new();
 	if (val != NULL) {
@@ -344,6 +336,30 @@ _handle_kvs_get(int fd, int lrank, client_req_t *req)
 	rc = client_resp_send(resp, fd);
 	client_resp_free(resp);
 
+	return rc;
+}
+
+static int
+_handle_kvs_get(int fd, int lrank, client_req_t *req)
+{
+	int rc;
+	char *key = NULL, *val;
+
+	debug3("mpi/pmi2: in _handle_kvs_get");
+
+	client_req_parse_body(req);
+	client_req_get_str(req, KEY_KEY, &key);
+
+	val = kvs_get(key);
+	if (!val && (kvs_direct_fetch(key, fd, _send_kvs_get_resp) ==
+		     SLURM_SUCCESS)) {
+		/* answered when the home node of the key responds */
+		rc = SLURM_SUCCESS;
+	} else {
+		rc = _send_kvs_get_resp(fd, val);
+	}
+	xfree(key);
+
 	debug3("mpi/pmi2: out _handle_kvs_get");
 	return rc;
 }
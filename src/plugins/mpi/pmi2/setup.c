@@ -335,6 +335,10 @@ _setup_stepd_kvs(char ***env)
 	if (rc != SLURM_SUCCESS)
 		return rc;
 
+	p = getenvp(*env, PMI2_KVS_DIRECT_ENV);
+	if (p && (atoi(p) > 0) && (job_info.nnodes > 1))
+		kvs_direct = 1;
+
 	rc = kvs_init();
 	if (rc != SLURM_SUCCESS)
 		return rc;
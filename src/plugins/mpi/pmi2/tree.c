@@ -68,6 +68,9 @@ static int _handle_name_unpublish(int fd, Buf buf);
 static int _handle_name_lookup(int fd, Buf buf);
 static int _handle_ring(int fd, Buf buf);
 static int _handle_ring_resp(int fd, Buf buf);
+static int _handle_kvs_shard(int fd, Buf buf);
+static int _handle_kvs_get(int fd, Buf buf);
+static int _handle_kvs_get_resp(int fd, Buf buf);
 
 static uint32_t  spawned_srun_ports_size = 0;
 static uint16_t *spawned_srun_ports = NULL;
@@ -83,6 +86,9 @@ static int (*tree_cmd_handlers[]) (int fd, Buf buf) = {
 	_handle_name_lookup,
 	_handle_ring,
 	_handle_ring_resp,
+	_handle_kvs_shard,
+	_handle_kvs_get,
+	_handle_kvs_get_resp,
 	NULL
 };
 
@@ -96,6 +102,9 @@ static char *tree_cmd_names[] = {
 	"TREE_CMD_NAME_LOOKUP",
 	"TREE_CMD_RING",
 	"TREE_CMD_RING_RESP",
+	"TREE_CMD_KVS_SHARD",
+	"TREE_CMD_KVS_GET",
+	"TREE_CMD_KVS_GET_RESP",
 	NULL,
 };
 
@@ -130,6 +139,7 @@ _handle_kvs_fence(int fd, Buf buf)
 	if (tasks_to_wait == 0 && children_to_wait == 0) {
 		tasks_to_wait = job_info.ltasks;
 		children_to_wait = tree_info.num_children;
+		kvs_fence_begin();
 	}
 	children_to_wait -= num_children;
 
@@ -208,6 +218,7 @@ _handle_kvs_fence_resp(int fd, Buf buf)
 		xfree(key);
 		xfree(val);
 	}
+	kvs_fence_done(get_buf_offset(buf));
 
 resp:
 	send_kvs_fence_resp_to_clients(rc, errmsg);
@@ -594,6 +605,78 @@ unpack_error:
 	goto out;
 }
 
+/* only called in stepd, on the home node of the keys */
+static int
+_handle_kvs_shard(int fd, Buf buf)
+{
+	uint32_t from_nodeid, temp32;
+	char *key = NULL, *val = NULL;
+	int rc = SLURM_SUCCESS;
+
+	safe_unpack32(&from_nodeid, buf);
+	debug3("mpi/pmi2: in _handle_kvs_shard, from node %u, %u bytes",
+	       from_nodeid, remaining_buf(buf));
+
+	while (remaining_buf(buf) > 0) {
+		safe_unpackstr_xmalloc(&key, &temp32, buf);
+		safe_unpackstr_xmalloc(&val, &temp32, buf);
+		kvs_put(key, val);
+		xfree(key);
+		xfree(val);
+	}
+	return rc;
+
+unpack_error:
+	error("mpi/pmi2: failed to unpack kvs shard message");
+	xfree(key);
+	return SLURM_ERROR;
+}
+
+/* only called in stepd, on the home node of the key */
+static int
+_handle_kvs_get(int fd, Buf buf)
+{
+	uint32_t from_nodeid, temp32;
+	char *key = NULL;
+	int rc;
+
+	safe_unpack32(&from_nodeid, buf);
+	safe_unpackstr_xmalloc(&key, &temp32, buf);
+	debug3("mpi/pmi2: in _handle_kvs_get, key=%s from node %u",
+	       key, from_nodeid);
+
+	rc = kvs_direct_serve(from_nodeid, key);
+	xfree(key);
+	return rc;
+
+unpack_error:
+	error("mpi/pmi2: failed to unpack kvs get message");
+	return SLURM_ERROR;
+}
+
+/* only called in stepd */
+static int
+_handle_kvs_get_resp(int fd, Buf buf)
+{
+	uint32_t temp32;
+	char *key = NULL, *val = NULL;
+	int rc;
+
+	safe_unpackstr_xmalloc(&key, &temp32, buf);
+	safe_unpackstr_xmalloc(&val, &temp32, buf);
+	debug3("mpi/pmi2: in _handle_kvs_get_resp, key=%s", key);
+
+	rc = kvs_direct_deliver(key, val);
+	xfree(key);
+	xfree(val);
+	return rc;
+
+unpack_error:
+	error("mpi/pmi2: failed to unpack kvs get response message");
+	xfree(key);
+	return SLURM_ERROR;
+}
+
 /**************************************************************/
 extern int
 handle_tree_cmd(int fd)
@@ -48,6 +48,9 @@ enum {
 	TREE_CMD_NAME_LOOKUP,
 	TREE_CMD_RING,
 	TREE_CMD_RING_RESP,
+	TREE_CMD_KVS_SHARD,
+	TREE_CMD_KVS_GET,
+	TREE_CMD_KVS_GET_RESP,
 	TREE_CMD_COUNT
 };
 
@@ -103,12 +103,22 @@ static pmix_status_t _fencenb_fn(const pmix_proc_t procs_v2[], size_t nprocs,
 {
 	PMIXP_DEBUG("called");
 	pmixp_coll_t *coll;
-	pmixp_coll_type_t type = PMIXP_COLL_TYPE_FENCE;
+	pmixp_coll_type_t type;
 	pmix_status_t status = PMIX_SUCCESS;
+	bool collect = false;
 	int ret;
 	size_t i;
 	pmixp_proc_t *procs = xmalloc(sizeof(*procs) * nprocs);
 
+	for (i = 0; i < ninfo; i++) {
+		if (!xstrcmp(info[i].key, PMIX_COLLECT_DATA)) {
+			collect = (PMIX_UNDEF == info[i].value.type) ||
+				  ((PMIX_BOOL == info[i].value.type) &&
+				   info[i].value.data.flag);
+		}
+	}
+	type = pmixp_coll_fence_type(collect);
+
 	for (i = 0; i < nprocs; i++) {
 		procs[i].rank = procs_v2[i].rank;
 		strncpy(procs[i].nspace, procs_v2[i].nspace, PMIXP_MAX_NSLEN);
@@ -38,6 +38,8 @@
 #include "pmixp_common.h"
 #include "src/slurmd/common/reverse_tree_math.h"
 #include "src/common/slurm_protocol_api.h"
+#include "src/common/slurm_route.h"
+#include "src/common/timers.h"
 #include "pmixp_coll.h"
 #include "pmixp_nspaces.h"
 #include "pmixp_server.h"
@@ -78,7 +80,44 @@ err_exit:
 	return SLURM_ERROR;
 }
 
-static int _pack_coll_info(pmixp_coll_t *coll, Buf buf)
+/*
+ * Order the peers so that the nodes behind one switch are adjacent.
+ * route/topology splits a hostlist along the switch hierarchy from
+ * topology.conf. Concatenating the pieces recursively makes every switch a
+ * contiguous range of peers, which reverse_tree_info() maps onto one subtree
+ * and the ring onto consecutive hops.
+ */
+static hostlist_t _hostset_topo_order(hostlist_t hl)
+{
+	hostlist_t *sp_hl = NULL, tmp, out;
+	int i, count = 0;
+
+	if (hostlist_count(hl) < 2)
+		return hostlist_copy(hl);
+
+	/* the split may consume its input */
+	tmp = hostlist_copy(hl);
+	if (route_g_split_hostlist(tmp, &sp_hl, &count, 0) || (count < 2)) {
+		for (i = 0; i < count; i++)
+			hostlist_destroy(sp_hl[i]);
+		xfree(sp_hl);
+		hostlist_destroy(tmp);
+		return hostlist_copy(hl);
+	}
+	hostlist_destroy(tmp);
+
+	out = hostlist_create("");
+	for (i = 0; i < count; i++) {
+		tmp = _hostset_topo_order(sp_hl[i]);
+		hostlist_push_list(out, tmp);
+		hostlist_destroy(tmp);
+		hostlist_destroy(sp_hl[i]);
+	}
+	xfree(sp_hl);
+	return out;
+}
+
+int pmixp_coll_pack_info(pmixp_coll_t *coll, Buf buf)
 {
 	pmixp_proc_t *procs = coll->pset.procs;
 	size_t nprocs = coll->pset.nprocs;
@@ -176,7 +215,7 @@ static void _reset_coll_ufwd(pmixp_coll_t *coll)
 	memset(coll->contrib_chld, 0,
 	       sizeof(coll->contrib_chld[0]) * coll->chldrn_cnt);
 	coll->serv_offs = pmixp_server_buf_reset(coll->ufwd_buf);
-	if (SLURM_SUCCESS != _pack_coll_info(coll, coll->ufwd_buf)) {
+	if (SLURM_SUCCESS != pmixp_coll_pack_info(coll, coll->ufwd_buf)) {
 		PMIXP_ERROR("Cannot pack ranges to message header!");
 	}
 	coll->ufwd_offset = get_buf_offset(coll->ufwd_buf);
@@ -187,7 +226,7 @@ static void _reset_coll_dfwd(pmixp_coll_t *coll)
 {
 	/* downwards status */
 	(void)pmixp_server_buf_reset(coll->dfwd_buf);
-	if (SLURM_SUCCESS != _pack_coll_info(coll, coll->dfwd_buf)) {
+	if (SLURM_SUCCESS != pmixp_coll_pack_info(coll, coll->dfwd_buf)) {
 		PMIXP_ERROR("Cannot pack ranges to message header!");
 	}
 	coll->dfwd_cb_cnt = 0;
@@ -227,6 +266,7 @@ static void _reset_coll(pmixp_coll_t *coll)
 		if (coll->contrib_local || coll->contrib_children) {
 			/* next collective was already started */
 			coll->state = PMIXP_COLL_COLLECT;
+			gettimeofday(&coll->tv_start, NULL);
 		} else {
 			coll->state = PMIXP_COLL_SYNC;
 		}
@@ -246,6 +286,64 @@ static void _reset_coll(pmixp_coll_t *coll)
 }
 
 
+static bool _use_topo_order(void)
+{
+	static int use_topo = -1;
+
+	if (use_topo == -1) {
+		char *route = slurm_get_route_plugin();
+		use_topo = !xstrcmp(route, "route/topology");
+		xfree(route);
+	}
+	return use_topo;
+}
+
+/*
+ * Select the fence algorithm. All nodes have to make the same choice, so it
+ * may only depend on job-wide information: the PMIX_COLLECT_DATA flag, which
+ * all processes pass identically, and the node count.
+ */
+pmixp_coll_type_t pmixp_coll_fence_type(bool collect)
+{
+	switch (pmixp_info_srv_fence_alg()) {
+	case PMIXP_FENCE_ALG_TREE:
+		return PMIXP_COLL_TYPE_FENCE;
+	case PMIXP_FENCE_ALG_RING:
+		return PMIXP_COLL_TYPE_FENCE_RING;
+	default:
+		break;
+	}
+	/* A barrier only moves a few bytes per node and the tree has
+	 * logarithmic depth. A data exchange is bandwidth bound and the ring
+	 * moves every byte exactly once per link, as long as the number of
+	 * hops stays reasonable. */
+	if (collect && (pmixp_info_nodes() > 2) &&
+	    (pmixp_info_nodes() <= PMIXP_COLL_RING_MAX_NODES))
+		return PMIXP_COLL_TYPE_FENCE_RING;
+	return PMIXP_COLL_TYPE_FENCE;
+}
+
+/* account one completed fence */
+void pmixp_coll_stat_add(pmixp_coll_t *coll, struct timeval *start,
+			 size_t size)
+{
+	struct timeval now;
+	char tv_str[20] = "";
+	long delta_t;
+
+	gettimeofday(&now, NULL);
+	slurm_diff_tv_str(start, &now, tv_str, sizeof(tv_str), NULL, 0,
+			  &delta_t);
+	coll->stat_cnt++;
+	coll->stat_usec += delta_t;
+	coll->stat_usec_max = MAX(coll->stat_usec_max, delta_t);
+	coll->stat_bytes += size;
+	PMIXP_DEBUG("%p: fence #%u (%s) done in %s, %zu bytes",
+		    coll, coll->stat_cnt,
+		    (PMIXP_COLL_TYPE_FENCE_RING == coll->type) ?
+		    "ring" : "tree", tv_str, size);
+}
+
 /*
  * Based on ideas provided by Hongjia Cao <hjcao@nudt.edu.cn> in PMI2 plugin
  */
@@ -270,6 +368,11 @@ int pmixp_coll_init(pmixp_coll_t *coll, const pmixp_proc_t *procs,
 		PMIXP_ERROR("Bad ranges information");
 		goto err_exit;
 	}
+	if (_use_topo_order()) {
+		hostlist_t topo_hl = _hostset_topo_order(hl);
+		hostlist_destroy(hl);
+		hl = topo_hl;
+	}
 #ifdef PMIXP_COLL_DEBUG
 	/* if we debug collectives - store a copy of a full
 	 * hostlist to resolve participant id to the hostname */
@@ -341,6 +444,8 @@ int pmixp_coll_init(pmixp_coll_t *coll, const pmixp_proc_t *procs,
 		coll->chldrn_ids[i] = pmixp_info_job_hostid(p);
 		free(p);
 	}
+	if (PMIXP_COLL_TYPE_FENCE_RING == type)
+		pmixp_coll_ring_init(coll, hl);
 	hostlist_destroy(hl);
 
 	/* Collective state */
@@ -361,6 +466,17 @@ err_exit:
 
 void pmixp_coll_free(pmixp_coll_t *coll)
 {
+	if (coll->stat_cnt) {
+		PMIXP_DEBUG("%p: %u fences (%s), avg %"PRIu64" usec, "
+			    "max %"PRIu64" usec, %"PRIu64" bytes",
+			    coll, coll->stat_cnt,
+			    (PMIXP_COLL_TYPE_FENCE_RING == coll->type) ?
+			    "ring" : "tree",
+			    coll->stat_usec / coll->stat_cnt,
+			    coll->stat_usec_max, coll->stat_bytes);
+	}
+	if (PMIXP_COLL_TYPE_FENCE_RING == coll->type)
+		pmixp_coll_ring_free(coll);
 	if (NULL != coll->pset.procs) {
 		xfree(coll->pset.procs);
 	}
@@ -886,6 +1002,8 @@ static int _progress_dfwd(pmixp_coll_t *coll)
 #ifdef PMIXP_COLL_DEBUG
 	PMIXP_DEBUG("%p: collective is DONE", coll);
 #endif
+	pmixp_coll_stat_add(coll, &coll->tv_start,
+			    get_buf_offset(coll->dfwd_buf) - coll->dfwd_offset);
 	_reset_coll(coll);
 
 	return true;
@@ -937,6 +1055,9 @@ int pmixp_coll_contrib_local(pmixp_coll_t *coll, char *data, size_t size,
 	/* sanity check */
 	pmixp_coll_sanity_check(coll);
 
+	if (PMIXP_COLL_TYPE_FENCE_RING == coll->type)
+		return pmixp_coll_ring_local(coll, data, size, cbfunc, cbdata);
+
 	/* lock the structure */
 	slurm_mutex_lock(&coll->lock);
 
@@ -949,6 +1070,7 @@ int pmixp_coll_contrib_local(pmixp_coll_t *coll, char *data, size_t size,
 	case PMIXP_COLL_SYNC:
 		/* change the state */
 		coll->ts = time(NULL);
+		gettimeofday(&coll->tv_start, NULL);
 		/* fall-thru */
 	case PMIXP_COLL_COLLECT:
 		/* sanity check */
@@ -1075,6 +1197,7 @@ int pmixp_coll_contrib_child(pmixp_coll_t *coll, uint32_t peerid,
 	case PMIXP_COLL_SYNC:
 		/* change the state */
 		coll->ts = time(NULL);
+		gettimeofday(&coll->tv_start, NULL);
 		/* fall-thru */
 	case PMIXP_COLL_COLLECT:
 		/* sanity check */
@@ -1340,6 +1463,11 @@ proceed:
 
 void pmixp_coll_reset_if_to(pmixp_coll_t *coll, time_t ts)
 {
+	if (PMIXP_COLL_TYPE_FENCE_RING == coll->type) {
+		pmixp_coll_ring_reset_if_to(coll, ts);
+		return;
+	}
+
 	/* lock the */
 	slurm_mutex_lock(&coll->lock);
 
@@ -37,6 +37,7 @@
 
 #ifndef PMIXP_COLL_H
 #define PMIXP_COLL_H
+#include <sys/time.h>
 #include "pmixp_common.h"
 #include "pmixp_debug.h"
 
@@ -99,9 +100,35 @@ pmixp_coll_sndstatus2str(pmixp_coll_sndstate_t state)
 typedef enum {
 	PMIXP_COLL_TYPE_FENCE,
 	PMIXP_COLL_TYPE_CONNECT,
-	PMIXP_COLL_TYPE_DISCONNECT
+	PMIXP_COLL_TYPE_DISCONNECT,
+	PMIXP_COLL_TYPE_FENCE_RING
 } pmixp_coll_type_t;
 
+/* Ring fences carrying data are used on up to this many nodes by default.
+ * A ring needs (nodes - 1) sequential hops, beyond that the tree wins. */
+#define PMIXP_COLL_RING_MAX_NODES 256
+
+/* A node can be at most one ring fence ahead of its neighbours */
+#define PMIXP_COLL_RING_CTX_NUM 2
+
+typedef struct {
+	bool in_use;
+	uint32_t seq;
+	bool contrib_local;
+	uint32_t contrib_prev;	/* contributions received from the ring */
+	bool *contrib_map;	/* which peers have contributed */
+	bool delivered;		/* waiting for libpmix to release the data */
+	Buf ring_buf;		/* data of all contributors */
+
+	/* libpmix callback data */
+	void *cbfunc;
+	void *cbdata;
+
+	/* stale detection and latency accounting */
+	time_t ts;
+	struct timeval tv_start;
+} pmixp_coll_ring_ctx_t;
+
 typedef enum {
 	PMIXP_COLL_REQ_PROGRESS,
 	PMIXP_COLL_REQ_SKIP,
@@ -160,8 +187,20 @@ typedef struct {
 	void *cbfunc;
 	void *cbdata;
 
+	/* ring algorithm state */
+	struct {
+		int prev_peerid;
+		int next_peerid;
+		pmixp_coll_ring_ctx_t ctx[PMIXP_COLL_RING_CTX_NUM];
+	} ring;
+
 	/* timestamp for stale collectives detection */
 	time_t ts, ts_next;
+
+	/* per-fence latency and size counters */
+	struct timeval tv_start;
+	uint32_t stat_cnt;
+	uint64_t stat_usec, stat_usec_max, stat_bytes;
 } pmixp_coll_t;
 
 static inline void pmixp_coll_sanity_check(pmixp_coll_t *coll)
@@ -175,6 +214,9 @@ int pmixp_coll_init(pmixp_coll_t *coll, const pmixp_proc_t *procs,
 void pmixp_coll_free(pmixp_coll_t *coll);
 
 pmixp_coll_t *pmixp_coll_from_cbdata(void *cbdata);
+pmixp_coll_type_t pmixp_coll_fence_type(bool collect);
+void pmixp_coll_stat_add(pmixp_coll_t *coll, struct timeval *start,
+			 size_t size);
 
 /*
  * This is important routine that takes responsibility to decide
@@ -254,6 +296,7 @@ int pmixp_coll_contrib_parent(pmixp_coll_t *coll, uint32_t nodeid,
 void pmixp_coll_bcast(pmixp_coll_t *coll);
 bool pmixp_coll_progress(pmixp_coll_t *coll, char *fwd_node,
 			 void **data, uint64_t size);
+int pmixp_coll_pack_info(pmixp_coll_t *coll, Buf buf);
 int pmixp_coll_unpack_info(Buf buf, pmixp_coll_type_t *type,
 			   int *nodeid, pmixp_proc_t **r,
 			   size_t *nr);
@@ -261,4 +304,13 @@ int pmixp_coll_belong_chk(pmixp_coll_type_t type,
 			  const pmixp_proc_t *procs, size_t nprocs);
 void pmixp_coll_reset_if_to(pmixp_coll_t *coll, time_t ts);
 
+/* ring algorithm, see pmixp_coll_ring.c */
+int pmixp_coll_ring_init(pmixp_coll_t *coll, hostlist_t hl);
+void pmixp_coll_ring_free(pmixp_coll_t *coll);
+int pmixp_coll_ring_local(pmixp_coll_t *coll, char *data, size_t size,
+			  void *cbfunc, void *cbdata);
+int pmixp_coll_ring_neighbor(pmixp_coll_t *coll, uint32_t peerid,
+			     uint32_t seq, Buf buf);
+void pmixp_coll_ring_reset_if_to(pmixp_coll_t *coll, time_t ts);
+
 #endif /* PMIXP_COLL_H */
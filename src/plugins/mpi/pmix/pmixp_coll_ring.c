@@ -0,0 +1,386 @@
+/*****************************************************************************\
+ **  pmixp_coll_ring.c - PMIx ring collective primitives
+ *****************************************************************************
+ *  Copyright (C) 2018 SchedMD LLC.
+ *
+ *  This file is part of Slurm, a resource management program.
+ *  For details, see <https://slurm.schedmd.com/>.
+ *  Please also read the included file: DISCLAIMER.
+ *
+ *  Slurm is free software; you can redistribute it and/or modify it under
+ *  the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  In addition, as a special exception, the copyright holders give permission
+ *  to link the code of portions of this program with the OpenSSL library under
+ *  certain conditions as described in each individual source file, and
+ *  distribute linked combinations including the two. You must obey the GNU
+ *  General Public License in all respects for all of the code used other than
+ *  OpenSSL. If you modify file(s) with this exception, you may extend this
+ *  exception to your version of the file(s), but you are not obligated to do
+ *  so. If you do not wish to do so, delete this exception statement from your
+ *  version.  If you delete this exception statement from all source files in
+ *  the program, then also delete it here.
+ *
+ *  Slurm is distributed in the hope that it will be useful, but WITHOUT ANY
+ *  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *  FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ *  details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with Slurm; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA.
+ \*****************************************************************************/
+
+#include "pmixp_common.h"
+#include "pmixp_coll.h"
+#include "pmixp_server.h"
+#include "pmixp_client.h"
+
+/*
+ * Ring allgather: every node sends its contribution to the next node in the
+ * ring, and every node forwards what it receives from the previous node
+ * until the contribution has visited all (peers_cnt - 1) other nodes. Each
+ * byte crosses every link once, which makes this the bandwidth-optimal
+ * choice for fences that carry data.
+ *
+ * Neighbours may already work on the next fence while we complete the
+ * current one, so received data is kept in one of PMIXP_COLL_RING_CTX_NUM
+ * contexts selected by the sequence number.
+ */
+
+typedef struct {
+	pmixp_coll_t *coll;
+	uint32_t seq;
+	Buf buf;
+} pmixp_coll_ring_cbdata_t;
+
+static void _ring_progress(pmixp_coll_t *coll, pmixp_coll_ring_ctx_t *ctx);
+
+static void _ring_ctx_reset(pmixp_coll_t *coll, pmixp_coll_ring_ctx_t *ctx)
+{
+	ctx->in_use = false;
+	ctx->contrib_local = false;
+	ctx->contrib_prev = 0;
+	ctx->delivered = false;
+	memset(ctx->contrib_map, 0, sizeof(bool) * coll->peers_cnt);
+	set_buf_offset(ctx->ring_buf, 0);
+	ctx->cbfunc = NULL;
+	ctx->cbdata = NULL;
+}
+
+static pmixp_coll_ring_ctx_t *_ring_ctx(pmixp_coll_t *coll, uint32_t seq)
+{
+	pmixp_coll_ring_ctx_t *ctx;
+
+	ctx = &coll->ring.ctx[seq % PMIXP_COLL_RING_CTX_NUM];
+	if (!ctx->in_use) {
+		ctx->in_use = true;
+		ctx->seq = seq;
+		ctx->ts = time(NULL);
+		gettimeofday(&ctx->tv_start, NULL);
+	} else if (ctx->seq != seq) {
+		/* the fence using this context has not been released by
+		 * libpmix yet */
+		PMIXP_ERROR("%p: ring context busy with seq=%u, requested %u",
+			    coll, ctx->seq, seq);
+		return NULL;
+	}
+	return ctx;
+}
+
+int pmixp_coll_ring_init(pmixp_coll_t *coll, hostlist_t hl)
+{
+	char *p;
+	int i;
+
+	p = hostlist_nth(hl, (coll->my_peerid + 1) % coll->peers_cnt);
+	coll->ring.next_peerid = pmixp_info_job_hostid(p);
+	free(p);
+	p = hostlist_nth(hl, (coll->my_peerid + coll->peers_cnt - 1) %
+			 coll->peers_cnt);
+	coll->ring.prev_peerid = pmixp_info_job_hostid(p);
+	free(p);
+
+	for (i = 0; i < PMIXP_COLL_RING_CTX_NUM; i++) {
+		pmixp_coll_ring_ctx_t *ctx = &coll->ring.ctx[i];
+		ctx->contrib_map = xmalloc(sizeof(bool) * coll->peers_cnt);
+		ctx->ring_buf = init_buf(BUF_SIZE);
+		_ring_ctx_reset(coll, ctx);
+	}
+	PMIXP_DEBUG("%p: ring of %d peers, prev=%d next=%d",
+		    coll, coll->peers_cnt, coll->ring.prev_peerid,
+		    coll->ring.next_peerid);
+
+	return SLURM_SUCCESS;
+}
+
+void pmixp_coll_ring_free(pmixp_coll_t *coll)
+{
+	int i;
+
+	for (i = 0; i < PMIXP_COLL_RING_CTX_NUM; i++) {
+		pmixp_coll_ring_ctx_t *ctx = &coll->ring.ctx[i];
+		xfree(ctx->contrib_map);
+		FREE_NULL_BUFFER(ctx->ring_buf);
+	}
+}
+
+/* drop a fence that can't complete and report it to libpmix */
+static void _ring_abort(pmixp_coll_t *coll, pmixp_coll_ring_ctx_t *ctx,
+			int status)
+{
+	if (ctx->contrib_local && ctx->cbfunc) {
+		pmixp_lib_modex_invoke(ctx->cbfunc, status, NULL, 0,
+				       ctx->cbdata, NULL, NULL);
+	}
+	if (ctx->seq == coll->seq)
+		coll->seq++;
+	_ring_ctx_reset(coll, ctx);
+}
+
+static void _ring_sent_cb(int rc, pmixp_p2p_ctx_t p2p_ctx, void *_vcbdata)
+{
+	pmixp_coll_ring_cbdata_t *cbdata = (pmixp_coll_ring_cbdata_t *)_vcbdata;
+	pmixp_coll_t *coll = cbdata->coll;
+	pmixp_coll_ring_ctx_t *ctx;
+
+	free_buf(cbdata->buf);
+	if (SLURM_SUCCESS != rc) {
+		if (PMIXP_P2P_REGULAR == p2p_ctx) {
+			/* lock the collective */
+			slurm_mutex_lock(&coll->lock);
+		}
+		ctx = &coll->ring.ctx[cbdata->seq % PMIXP_COLL_RING_CTX_NUM];
+		PMIXP_ERROR("%p: failed to send to the next node %d, seq=%u",
+			    coll, coll->ring.next_peerid, cbdata->seq);
+		if (ctx->in_use && (ctx->seq == cbdata->seq) &&
+		    !ctx->delivered)
+			_ring_abort(coll, ctx, SLURM_ERROR);
+		if (PMIXP_P2P_REGULAR == p2p_ctx) {
+			/* unlock the collective */
+			slurm_mutex_unlock(&coll->lock);
+		}
+	}
+	xfree(cbdata);
+}
+
+/* pass the contribution of peer `origin` on to the next node */
+static int _ring_send(pmixp_coll_t *coll, uint32_t seq, uint32_t origin,
+		      uint32_t hop, char *data, size_t size)
+{
+	pmixp_coll_ring_cbdata_t *cbdata;
+	pmixp_ep_t ep = {0};
+	Buf buf;
+	int rc;
+
+	buf = pmixp_server_buf_new();
+	pmixp_coll_pack_info(coll, buf);
+	pack32(origin, buf);
+	pack32(hop, buf);
+	pmixp_server_buf_reserve(buf, size);
+	memcpy(get_buf_data(buf) + get_buf_offset(buf), data, size);
+	set_buf_offset(buf, get_buf_offset(buf) + size);
+
+	cbdata = xmalloc(sizeof(pmixp_coll_ring_cbdata_t));
+	cbdata->coll = coll;
+	cbdata->seq = seq;
+	cbdata->buf = buf;
+
+	ep.type = PMIXP_EP_NOIDEID;
+	ep.ep.nodeid = coll->ring.next_peerid;
+#ifdef PMIXP_COLL_DEBUG
+	PMIXP_DEBUG("%p: seq=%u, fwd contrib of peer %u (hop %u) to %d, "
+		    "size = %zu", coll, seq, origin, hop, ep.ep.nodeid, size);
+#endif
+	rc = pmixp_server_send_nb(&ep, PMIXP_MSG_RING, seq, buf,
+				  _ring_sent_cb, cbdata);
+	if (SLURM_SUCCESS != rc) {
+		PMIXP_ERROR("%p: cannot send data (size = %zu) to %d",
+			    coll, size, ep.ep.nodeid);
+	}
+	return rc;
+}
+
+static void _libpmix_ring_cb(void *_vcbdata)
+{
+	pmixp_coll_ring_cbdata_t *cbdata = (pmixp_coll_ring_cbdata_t *)_vcbdata;
+	pmixp_coll_t *coll = cbdata->coll;
+	pmixp_coll_ring_ctx_t *ctx;
+
+	/* lock the collective */
+	slurm_mutex_lock(&coll->lock);
+	ctx = &coll->ring.ctx[cbdata->seq % PMIXP_COLL_RING_CTX_NUM];
+	if (ctx->in_use && (ctx->seq == cbdata->seq) && ctx->delivered)
+		_ring_ctx_reset(coll, ctx);
+	/* unlock the collective */
+	slurm_mutex_unlock(&coll->lock);
+
+	xfree(cbdata);
+}
+
+static void _ring_progress(pmixp_coll_t *coll, pmixp_coll_ring_ctx_t *ctx)
+{
+	pmixp_coll_ring_cbdata_t *cbdata;
+	size_t size;
+
+	if (ctx->delivered || !ctx->contrib_local ||
+	    (ctx->contrib_prev != (coll->peers_cnt - 1)))
+		return;
+
+	/* all contributions are here */
+	xassert(ctx->seq == coll->seq);
+	size = get_buf_offset(ctx->ring_buf);
+	pmixp_coll_stat_add(coll, &ctx->tv_start, size);
+	ctx->delivered = true;
+	coll->seq++;
+
+	if (!ctx->cbfunc) {
+		_ring_ctx_reset(coll, ctx);
+		return;
+	}
+	cbdata = xmalloc(sizeof(pmixp_coll_ring_cbdata_t));
+	cbdata->coll = coll;
+	cbdata->seq = ctx->seq;
+	pmixp_lib_modex_invoke(ctx->cbfunc, SLURM_SUCCESS,
+			       get_buf_data(ctx->ring_buf), size,
+			       ctx->cbdata, _libpmix_ring_cb, cbdata);
+}
+
+int pmixp_coll_ring_local(pmixp_coll_t *coll, char *data, size_t size,
+			  void *cbfunc, void *cbdata)
+{
+	pmixp_coll_ring_ctx_t *ctx;
+	int ret = SLURM_SUCCESS;
+
+	/* lock the structure */
+	slurm_mutex_lock(&coll->lock);
+
+#ifdef PMIXP_COLL_DEBUG
+	PMIXP_DEBUG("%p: contrib/loc: seqnum=%u, size=%zu",
+		    coll, coll->seq, size);
+#endif
+	if (!(ctx = _ring_ctx(coll, coll->seq))) {
+		ret = SLURM_ERROR;
+		goto exit;
+	}
+	if (ctx->contrib_local) {
+		/* Double contribution - reject */
+		ret = SLURM_ERROR;
+		goto exit;
+	}
+
+	/* save & mark local contribution */
+	ctx->contrib_local = true;
+	ctx->contrib_map[coll->my_peerid] = true;
+	grow_buf(ctx->ring_buf, size);
+	memcpy(get_buf_data(ctx->ring_buf) + get_buf_offset(ctx->ring_buf),
+	       data, size);
+	set_buf_offset(ctx->ring_buf, get_buf_offset(ctx->ring_buf) + size);
+	ctx->cbfunc = cbfunc;
+	ctx->cbdata = cbdata;
+
+	if ((coll->peers_cnt > 1) &&
+	    (SLURM_SUCCESS != _ring_send(coll, ctx->seq, coll->my_peerid, 0,
+					 data, size))) {
+		/* the callback has not been invoked for this fence yet,
+		 * report the failure through the return code */
+		ctx->cbfunc = NULL;
+		_ring_abort(coll, ctx, SLURM_ERROR);
+		ret = SLURM_ERROR;
+		goto exit;
+	}
+
+	_ring_progress(coll, ctx);
+exit:
+	/* unlock the structure */
+	slurm_mutex_unlock(&coll->lock);
+	return ret;
+}
+
+int pmixp_coll_ring_neighbor(pmixp_coll_t *coll, uint32_t peerid,
+			     uint32_t seq, Buf buf)
+{
+	pmixp_coll_ring_ctx_t *ctx;
+	uint32_t origin, hop, size;
+	char *data;
+
+	/* lock the structure */
+	slurm_mutex_lock(&coll->lock);
+	pmixp_coll_sanity_check(coll);
+
+	if (peerid != coll->ring.prev_peerid) {
+		char *nodename = pmixp_info_job_host(peerid);
+		PMIXP_ERROR("%p: ring contrib from bad nodeid=%s:%u, "
+			    "expect=%d",
+			    coll, nodename, peerid, coll->ring.prev_peerid);
+		xfree(nodename);
+		goto exit;
+	}
+	if ((SLURM_SUCCESS != unpack32(&origin, buf)) ||
+	    (SLURM_SUCCESS != unpack32(&hop, buf)) ||
+	    (origin >= coll->peers_cnt) || (hop >= coll->peers_cnt)) {
+		PMIXP_ERROR("%p: bad ring message from nodeid=%u",
+			    coll, peerid);
+		goto exit;
+	}
+	if (!(ctx = _ring_ctx(coll, seq)))
+		goto exit;
+
+	if (ctx->contrib_map[origin]) {
+		/* retransmission of a message we already have */
+		PMIXP_DEBUG("%p: multiple contribs of peer %u, seq=%u",
+			    coll, origin, seq);
+		goto exit;
+	}
+
+	data = get_buf_data(buf) + get_buf_offset(buf);
+	size = remaining_buf(buf);
+#ifdef PMIXP_COLL_DEBUG
+	PMIXP_DEBUG("%p: contrib/rem of peer %u (hop %u), seq=%u, size=%u",
+		    coll, origin, hop, seq, size);
+#endif
+	/* don't hand it back to the originator */
+	if ((hop + 1) < (coll->peers_cnt - 1) &&
+	    (SLURM_SUCCESS != _ring_send(coll, seq, origin, hop + 1,
+					 data, size))) {
+		_ring_abort(coll, ctx, SLURM_ERROR);
+		goto exit;
+	}
+
+	ctx->contrib_map[origin] = true;
+	ctx->contrib_prev++;
+	grow_buf(ctx->ring_buf, size);
+	memcpy(get_buf_data(ctx->ring_buf) + get_buf_offset(ctx->ring_buf),
+	       data, size);
+	set_buf_offset(ctx->ring_buf, get_buf_offset(ctx->ring_buf) + size);
+
+	_ring_progress(coll, ctx);
+exit:
+	/* unlock the structure */
+	slurm_mutex_unlock(&coll->lock);
+	return SLURM_SUCCESS;
+}
+
+void pmixp_coll_ring_reset_if_to(pmixp_coll_t *coll, time_t ts)
+{
+	pmixp_coll_ring_ctx_t *ctx;
+	int i;
+
+	/* lock the structure */
+	slurm_mutex_lock(&coll->lock);
+	for (i = 0; i < PMIXP_COLL_RING_CTX_NUM; i++) {
+		ctx = &coll->ring.ctx[i];
+		if (!ctx->in_use || ctx->delivered)
+			continue;
+		if (ts - ctx->ts > pmixp_info_timeout()) {
+			_ring_abort(coll, ctx, PMIXP_ERR_TIMEOUT);
+			/* report the timeout event */
+			PMIXP_ERROR("%p: ring collective timeout, seq=%u",
+				    coll, ctx->seq);
+		}
+	}
+	/* unlock the structure */
+	slurm_mutex_unlock(&coll->lock);
+}
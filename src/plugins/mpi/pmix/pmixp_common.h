@@ -95,6 +95,7 @@
 #define PMIXP_DIRECT_SAMEARCH "SLURM_PMIX_SAMEARCH"
 #define PMIXP_DIRECT_CONN "SLURM_PMIX_DIRECT_CONN"
 #define PMIXP_DIRECT_CONN_UCX "SLURM_PMIX_DIRECT_CONN_UCX"
+#define PMIXP_COLL_FENCE "SLURM_PMIX_FENCE"
 #define PMIXP_TMPDIR_DEFAULT "/tmp/"
 #define PMIXP_OS_TMPDIR_ENV "TMPDIR"
 /* This variable will be propagated to server-side
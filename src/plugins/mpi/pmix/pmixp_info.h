@@ -77,6 +77,12 @@ typedef struct {
 
 extern pmix_jobinfo_t _pmixp_job_info;
 
+typedef enum {
+	PMIXP_FENCE_ALG_AUTO,
+	PMIXP_FENCE_ALG_TREE,
+	PMIXP_FENCE_ALG_RING
+} pmixp_fence_alg_t;
+
 /* slurmd contact information */
 void pmixp_info_srv_usock_set(char *path, int fd);
 const char *pmixp_info_srv_usock_path(void);
@@ -85,6 +91,7 @@ bool pmixp_info_same_arch(void);
 bool pmixp_info_srv_direct_conn(void);
 bool pmixp_info_srv_direct_conn_early(void);
 bool pmixp_info_srv_direct_conn_ucx(void);
+pmixp_fence_alg_t pmixp_info_srv_fence_alg(void);
 
 
 static inline int pmixp_info_timeout(void)
@@ -779,7 +779,8 @@ static void _process_server_request(pmixp_base_hdr_t *hdr, Buf buf)
 
 	switch (hdr->type) {
 	case PMIXP_MSG_FAN_IN:
-	case PMIXP_MSG_FAN_OUT: {
+	case PMIXP_MSG_FAN_OUT:
+	case PMIXP_MSG_RING: {
 		pmixp_coll_t *coll;
 		pmixp_proc_t *procs = NULL;
 		size_t nprocs = 0;
@@ -801,8 +802,9 @@ static void _process_server_request(pmixp_base_hdr_t *hdr, Buf buf)
 		PMIXP_DEBUG("FENCE collective message from nodeid = %u, "
 			    "type = %s, seq = %d",
 			    hdr->nodeid,
-			    ((PMIXP_MSG_FAN_IN == hdr->type) ?
-				     "fan-in" : "fan-out"),
+			    ((PMIXP_MSG_FAN_IN == hdr->type) ? "fan-in" :
+			     (PMIXP_MSG_FAN_OUT == hdr->type) ? "fan-out" :
+			     "ring"),
 			    hdr->seq);
 		rc = pmixp_coll_check_seq(coll, hdr->seq);
 		if (PMIXP_COLL_REQ_FAILURE == rc) {
@@ -827,7 +829,10 @@ static void _process_server_request(pmixp_base_hdr_t *hdr, Buf buf)
 			goto exit;
 		}
 
-		if (PMIXP_MSG_FAN_IN == hdr->type) {
+		if (PMIXP_MSG_RING == hdr->type) {
+			pmixp_coll_ring_neighbor(coll, hdr->nodeid,
+						 hdr->seq, buf);
+		} else if (PMIXP_MSG_FAN_IN == hdr->type) {
 			pmixp_coll_contrib_child(coll, hdr->nodeid,
 						 hdr->seq, buf);
 		} else {
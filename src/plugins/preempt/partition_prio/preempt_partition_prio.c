@@ -39,6 +39,7 @@
 \*****************************************************************************/
 
 #include <stdio.h>
+#include <stdlib.h>
 
 #include "slurm/slurm_errno.h"
 
@@ -46,6 +47,7 @@
 #include "src/common/list.h"
 #include "src/common/log.h"
 #include "src/common/plugin.h"
+#include "src/common/xmalloc.h"
 #include "src/common/xstring.h"
 #include "src/slurmctld/slurmctld.h"
 #include "src/slurmctld/job_scheduler.h"
@@ -54,9 +56,15 @@ const char	plugin_name[]	= "Preempt by partition priority plugin";
 const char	plugin_type[]	= "preempt/partition_prio";
 const uint32_t	plugin_version	= SLURM_VERSION_NUMBER;
 
+/* Preemption candidate, with its sort key computed once */
+typedef struct preempt_cand {
+	struct job_record *job_ptr;
+	uint32_t prio;
+} preempt_cand_t;
+
 static uint32_t _gen_job_prio(struct job_record *job_ptr);
-static int _sort_by_prio(void *x, void *y);
-static int _sort_by_youngest(void *x, void *y);
+static int _sort_by_prio(const void *x, const void *y);
+static int _sort_by_youngest(const void *x, const void *y);
 
 static bool youngest_order = false;
 
@@ -81,6 +89,8 @@ extern List find_preemptable_jobs(struct job_record *job_ptr)
 	ListIterator job_iterator;
 	struct job_record *job_p;
 	List preemptee_job_list = NULL;
+	preempt_cand_t *cand = NULL;
+	int cand_cnt = 0, cand_size = 0, i;
 
 	/* Validate the preemptor job */
 	if (job_ptr == NULL) {
@@ -122,17 +132,28 @@ extern List find_preemptable_jobs(struct job_record *job_ptr)
 			continue;
 
 		/* This job is a preemption candidate */
-		if (preemptee_job_list == NULL) {
-			preemptee_job_list = list_create(NULL);
+		if (cand_cnt >= cand_size) {
+			cand_size = MAX(64, cand_size * 2);
+			xrealloc(cand, sizeof(preempt_cand_t) * cand_size);
 		}
-		list_append(preemptee_job_list, job_p);
+		cand[cand_cnt].job_ptr = job_p;
+		cand[cand_cnt].prio = _gen_job_prio(job_p);
+		cand_cnt++;
 	}
 	list_iterator_destroy(job_iterator);
 
-	if (preemptee_job_list && youngest_order)
-		list_sort(preemptee_job_list, _sort_by_youngest);
-	else if (preemptee_job_list)
-		list_sort(preemptee_job_list, _sort_by_prio);
+	if (cand_cnt == 0)
+		return preemptee_job_list;
+
+	if (youngest_order)
+		qsort(cand, cand_cnt, sizeof(preempt_cand_t),
+		      _sort_by_youngest);
+	else
+		qsort(cand, cand_cnt, sizeof(preempt_cand_t), _sort_by_prio);
+	preemptee_job_list = list_create(NULL);
+	for (i = 0; i < cand_cnt; i++)
+		list_append(preemptee_job_list, cand[i].job_ptr);
+	xfree(cand);
 
 	return preemptee_job_list;
 }
@@ -158,31 +179,31 @@ static uint32_t _gen_job_prio(struct job_record *job_ptr)
 	return job_prio;
 }
 
-static int _sort_by_prio(void *x, void *y)
+/*
+ * Order by priority. Among jobs of equal priority (and thus equal size),
+ * preempt the most recently started first since it loses the least work.
+ */
+static int _sort_by_prio(const void *x, const void *y)
 {
 	int rc;
-	uint32_t job_prio1, job_prio2;
-	struct job_record *j1 = *(struct job_record **)x;
-	struct job_record *j2 = *(struct job_record **)y;
-
-	job_prio1 = _gen_job_prio(j1);
-	job_prio2 = _gen_job_prio(j2);
+	preempt_cand_t *c1 = (preempt_cand_t *) x;
+	preempt_cand_t *c2 = (preempt_cand_t *) y;
 
-	if (job_prio1 > job_prio2)
+	if (c1->prio > c2->prio)
 		rc = 1;
-	else if (job_prio1 < job_prio2)
+	else if (c1->prio < c2->prio)
 		rc = -1;
 	else
-		rc = 0;
+		rc = _sort_by_youngest(x, y);
 
 	return rc;
 }
 
-static int _sort_by_youngest(void *x, void *y)
+static int _sort_by_youngest(const void *x, const void *y)
 {
 	int rc;
-	struct job_record *j1 = *(struct job_record **) x;
-	struct job_record *j2 = *(struct job_record **) y;
+	struct job_record *j1 = ((preempt_cand_t *) x)->job_ptr;
+	struct job_record *j2 = ((preempt_cand_t *) y)->job_ptr;
 
 	if (j1->start_time < j2->start_time)
 		rc = 1;
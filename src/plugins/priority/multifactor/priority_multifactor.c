@@ -1323,6 +1323,9 @@ static void *_decay_thread(void *no_data)
 		if (flags & PRIORITY_FLAGS_FAIR_TREE)
 			fair_tree_decay(job_list, start_time);
 
+		/* Let sshare read the new usage without the assoc locks */
+		assoc_mgr_publish_shares();
+
 		g_last_ran = start_time;
 
 		_write_last_decay_ran(g_last_ran, last_reset);
@@ -393,8 +393,10 @@ static int  _try_sched(struct job_record *job_ptr, bitstr_t **avail_bitmap,
 			if ((job_req_node_filter(job_ptr, *avail_bitmap, true)
 			     == SLURM_SUCCESS) &&
 			    (bit_set_count(*avail_bitmap) >= feat_min_node)) {
-				preemptee_candidates =
-					slurm_find_preemptable_jobs(job_ptr);
+				/* Candidates don't depend upon the feature */
+				if (!preemptee_candidates)
+					preemptee_candidates =
+					  slurm_find_preemptable_jobs(job_ptr);
 				rc = select_g_job_test(job_ptr, *avail_bitmap,
 						       feat_min_node, max_nodes,
 						       req_nodes,
@@ -461,8 +463,10 @@ static int  _try_sched(struct job_record *job_ptr, bitstr_t **avail_bitmap,
 			if ((job_req_node_filter(job_ptr, *avail_bitmap, true)
 			     == SLURM_SUCCESS) &&
 			    (bit_set_count(*avail_bitmap) >= min_nodes)) {
-				preemptee_candidates =
-					slurm_find_preemptable_jobs(job_ptr);
+				/* Candidates don't depend upon the feature */
+				if (!preemptee_candidates)
+					preemptee_candidates =
+					  slurm_find_preemptable_jobs(job_ptr);
 				rc = select_g_job_test(job_ptr, *avail_bitmap,
 						       min_nodes, max_nodes,
 						       req_nodes,
@@ -2032,6 +2032,21 @@ static int _eval_nodes_serial(struct job_record *job_ptr, bitstr_t *node_map,
 fini:	return error_code;
 }
 
+/*
+ * Return the bitmap of available nodes on switch sw_inx, building it on
+ * first use when the counts came from switch_leaf_counts().
+ */
+static bitstr_t *_topo_switch_bitmap(int sw_inx, bitstr_t **switches_bitmap,
+				     bitstr_t *avail_nodes_bitmap)
+{
+	if (!switches_bitmap[sw_inx]) {
+		switches_bitmap[sw_inx] =
+			bit_copy(switch_record_table[sw_inx].node_bitmap);
+		bit_and(switches_bitmap[sw_inx], avail_nodes_bitmap);
+	}
+	return switches_bitmap[sw_inx];
+}
+
 /*
  * A network topology aware version of _eval_nodes().
  * NOTE: The logic here is almost identical to that of _job_test_topo()
@@ -2058,7 +2073,7 @@ static int _eval_nodes_topo(struct job_record *job_ptr, bitstr_t *bitmap,
 	int best_fit_inx, first, last;
 	int best_fit_nodes, best_fit_cpus;
 	int best_fit_location = 0, best_fit_sufficient;
-	bool sufficient;
+	bool sufficient, use_leaf_index;
 	long time_waiting = 0;
 
 	if (job_ptr->req_switch) {
@@ -2092,7 +2107,12 @@ static int _eval_nodes_topo(struct job_record *job_ptr, bitstr_t *bitmap,
 	switches_node_cnt = xmalloc(sizeof(int)        * switch_record_cnt);
 	switches_required = xmalloc(sizeof(int)        * switch_record_cnt);
 	avail_nodes_bitmap = bit_alloc(cr_node_cnt);
-	for (i=0; i<switch_record_cnt; i++) {
+	use_leaf_index = switch_tree_strict && !req_nodes_bitmap;
+	if (use_leaf_index) {
+		switch_leaf_counts(bitmap, cpu_cnt, switches_cpu_cnt,
+				   switches_node_cnt, avail_nodes_bitmap);
+	}
+	for (i=0; (i<switch_record_cnt) && !use_leaf_index; i++) {
 		switches_bitmap[i] = bit_copy(switch_record_table[i].
 					      node_bitmap);
 		bit_and(switches_bitmap[i], bitmap);
@@ -2110,7 +2130,8 @@ static int _eval_nodes_topo(struct job_record *job_ptr, bitstr_t *bitmap,
 			char *node_names = NULL;
 			if (switches_node_cnt[i]) {
 				node_names = bitmap2node_name(
-						switches_bitmap[i]);
+					_topo_switch_bitmap(i, switches_bitmap,
+							avail_nodes_bitmap));
 			}
 			info("switch=%s level=%d nodes=%u:%s required:%u speed:%u",
 			     switch_record_table[i].name,
@@ -2214,7 +2235,7 @@ static int _eval_nodes_topo(struct job_record *job_ptr, bitstr_t *bitmap,
 				}
 			}
 		}
-	} else {
+	} else if (!use_leaf_index) {
 		/* No specific required nodes, calculate CPU counts */
 		for (j=0; j<switch_record_cnt; j++) {
 			first = bit_ffs(switches_bitmap[j]);
@@ -2290,12 +2311,18 @@ static int _eval_nodes_topo(struct job_record *job_ptr, bitstr_t *bitmap,
 		rc = SLURM_ERROR;
 		goto fini;
 	}
-	bit_and(avail_nodes_bitmap, switches_bitmap[best_fit_inx]);
+	if (use_leaf_index) {
+		bit_and(avail_nodes_bitmap,
+			switch_record_table[best_fit_inx].node_bitmap);
+	} else
+		bit_and(avail_nodes_bitmap, switches_bitmap[best_fit_inx]);
 
 	/* Identify usable leafs (within higher switch having best fit) */
 	for (j=0; j<switch_record_cnt; j++) {
 		if ((switch_record_table[j].level != 0) ||
-		    (!bit_super_set(switches_bitmap[j],
+		    (use_leaf_index && !switch_leaf_below(j, best_fit_inx)) ||
+		    (!use_leaf_index &&
+		     !bit_super_set(switches_bitmap[j],
 				    switches_bitmap[best_fit_inx]))) {
 			switches_node_cnt[j] = 0;
 		}
@@ -2357,6 +2384,8 @@ static int _eval_nodes_topo(struct job_record *job_ptr, bitstr_t *bitmap,
 
 		leaf_switch_count++;
 		/* Use select nodes from this leaf */
+		_topo_switch_bitmap(best_fit_location, switches_bitmap,
+				    avail_nodes_bitmap);
 		first = bit_ffs(switches_bitmap[best_fit_location]);
 		last  = bit_fls(switches_bitmap[best_fit_location]);
 
@@ -2516,6 +2545,7 @@ static int _eval_nodes_dfly(struct job_record *job_ptr, bitstr_t *bitmap,
 	long time_waiting = 0;
 	int req_switch_cnt = 0;
 	int req_switch_id = -1;
+	bool use_leaf_index;
 
 	if (job_ptr->req_switch > 1) {
 		/* Maximum leaf switch count >1 probably makes no sense */
@@ -2555,7 +2585,12 @@ static int _eval_nodes_dfly(struct job_record *job_ptr, bitstr_t *bitmap,
 	switches_node_cnt = xmalloc(sizeof(int)        * switch_record_cnt);
 	switches_node_use = xmalloc(sizeof(int)        * switch_record_cnt);
 	avail_nodes_bitmap = bit_alloc(cr_node_cnt);
-	for (i = 0; i < switch_record_cnt; i++) {
+	use_leaf_index = switch_tree_strict && !req_nodes_bitmap;
+	if (use_leaf_index) {
+		switch_leaf_counts(bitmap, cpu_cnt, switches_cpu_cnt,
+				   switches_node_cnt, avail_nodes_bitmap);
+	}
+	for (i = 0; (i < switch_record_cnt) && !use_leaf_index; i++) {
 		switches_bitmap[i] = bit_copy(switch_record_table[i].
 					      node_bitmap);
 		bit_and(switches_bitmap[i], bitmap);
@@ -2569,7 +2604,8 @@ static int _eval_nodes_dfly(struct job_record *job_ptr, bitstr_t *bitmap,
 			char *node_names = NULL;
 			if (switches_node_cnt[i]) {
 				node_names = bitmap2node_name(
-						switches_bitmap[i]);
+					_topo_switch_bitmap(i, switches_bitmap,
+							avail_nodes_bitmap));
 			}
 			debug("switch=%s nodes=%u:%s speed:%u",
 			      switch_record_table[i].name,
@@ -2674,7 +2710,7 @@ static int _eval_nodes_dfly(struct job_record *job_ptr, bitstr_t *bitmap,
 				}
 			}
 		}
-	} else {
+	} else if (!use_leaf_index) {
 		/* No specific required nodes, calculate CPU counts */
 		for (j = 0; j < switch_record_cnt; j++) {
 			first = bit_ffs(switches_bitmap[j]);
@@ -2733,12 +2769,18 @@ static int _eval_nodes_dfly(struct job_record *job_ptr, bitstr_t *bitmap,
 		rc = SLURM_ERROR;
 		goto fini;
 	}
-	bit_and(avail_nodes_bitmap, switches_bitmap[best_fit_inx]);
+	if (use_leaf_index) {
+		bit_and(avail_nodes_bitmap,
+			switch_record_table[best_fit_inx].node_bitmap);
+	} else
+		bit_and(avail_nodes_bitmap, switches_bitmap[best_fit_inx]);
 
 	/* Identify usable leafs (within higher switch having best fit) */
 	for (j = 0; j < switch_record_cnt; j++) {
 		if ((switch_record_table[j].level != 0) ||
-		    (!bit_super_set(switches_bitmap[j],
+		    (use_leaf_index && !switch_leaf_below(j, best_fit_inx)) ||
+		    (!use_leaf_index &&
+		     !bit_super_set(switches_bitmap[j],
 				    switches_bitmap[best_fit_inx]))) {
 			switches_node_cnt[j] = 0;
 		}
@@ -2774,6 +2816,8 @@ static int _eval_nodes_dfly(struct job_record *job_ptr, bitstr_t *bitmap,
 		/* Use select nodes from this leaf */
 		bit_set(switch_use_bitmap, best_fit_location);
 		leaf_switch_count = bit_set_count(switch_use_bitmap);
+		_topo_switch_bitmap(best_fit_location, switches_bitmap,
+				    avail_nodes_bitmap);
 		first = bit_ffs(switches_bitmap[best_fit_location]);
 		last  = bit_fls(switches_bitmap[best_fit_location]);
 
@@ -386,11 +386,31 @@ static struct node_use_record *_dup_node_usage(struct node_use_record *orig_ptr)
 			gres_list = orig_ptr[i].gres_list;
 		else
 			gres_list = node_record_table_ptr[i].gres_list;
-		new_ptr[i].gres_list = gres_plugin_node_state_dup(gres_list);
+		/*
+		 * Most simulated job removals touch a small part of the
+		 * cluster, so only copy a node's GRES state when a job is
+		 * removed from it.  See _rm_job_from_res().
+		 */
+		new_ptr[i].gres_list = gres_list;
+		new_ptr[i].gres_shared = true;
 	}
 	return new_use_ptr;
 }
 
+/* Log how many nodes a will_run test had to copy the GRES state of */
+static void _log_gres_copies(struct job_record *job_ptr,
+			     struct node_use_record *future_usage)
+{
+	int i, copy_cnt = 0;
+
+	for (i = 0; i < select_node_cnt; i++) {
+		if (!future_usage[i].gres_shared)
+			copy_cnt++;
+	}
+	info("cons_res: will_run test of job %u copied GRES state of %d of %d "
+	     "nodes", job_ptr->job_id, copy_cnt, select_node_cnt);
+}
+
 /* delete the given row data */
 static void _destroy_row_data(struct part_row_data *row, uint16_t num_rows) {
 	uint16_t i;
@@ -499,7 +519,8 @@ static void _destroy_node_data(struct node_use_record *node_usage,
 	xfree(node_data);
 	if (node_usage) {
 		for (i = 0; i < select_node_cnt; i++) {
-			FREE_NULL_LIST(node_usage[i].gres_list);
+			if (!node_usage[i].gres_shared)
+				FREE_NULL_LIST(node_usage[i].gres_list);
 		}
 		xfree(node_usage);
 	}
@@ -1217,6 +1238,13 @@ static int _rm_job_from_res(struct part_res_record *part_record_ptr,
 
 		node_ptr = node_record_table_ptr + i;
 		if (action != 2) {
+			if (node_usage[i].gres_shared) {
+				/* Copy on first change, see _dup_node_usage */
+				node_usage[i].gres_list =
+					gres_plugin_node_state_dup(
+						node_usage[i].gres_list);
+				node_usage[i].gres_shared = false;
+			}
 			if (node_usage[i].gres_list)
 				gres_list = node_usage[i].gres_list;
 			else
@@ -2011,6 +2039,8 @@ static int _will_run_test(struct job_record *job_ptr, bitstr_t *bitmap,
 		list_iterator_destroy(preemptee_iterator);
 	}
 
+	if (select_debug_flags & DEBUG_FLAG_SELECT_TYPE)
+		_log_gres_copies(job_ptr, future_usage);
 	FREE_NULL_LIST(cr_job_list);
 	_destroy_part_data(future_part);
 	_destroy_node_data(future_usage, NULL);
@@ -101,6 +101,9 @@ struct node_use_record {
 					 * scheduled jobs */
 	List gres_list;			/* list of gres state info managed by 
 					 * plugins */
+	bool gres_shared;		/* gres_list belongs to the record this
+					 * one was copied from, copy it before
+					 * making any change */
 	uint16_t node_state;		/* see node_cr_state comments */
 };
 
@@ -386,6 +386,13 @@ extern int rm_job_res(struct part_res_record *part_record_ptr,
 
 		node_ptr = node_record_table_ptr + i;
 		if (action != 2) {
+			if (node_usage[i].gres_shared) {
+				/* Copy on first change, see _dup_node_usage */
+				node_usage[i].gres_list =
+					gres_plugin_node_state_dup(
+						node_usage[i].gres_list);
+				node_usage[i].gres_shared = false;
+			}
 			if (node_usage[i].gres_list)
 				gres_list = node_usage[i].gres_list;
 			else
@@ -776,11 +783,31 @@ static struct node_use_record *_dup_node_usage(struct node_use_record *orig_ptr)
 			gres_list = orig_ptr[i].gres_list;
 		else
 			gres_list = node_record_table_ptr[i].gres_list;
-		new_ptr[i].gres_list = gres_plugin_node_state_dup(gres_list);
+		/*
+		 * Most simulated job removals touch a small part of the
+		 * cluster, so only copy a node's GRES state when a job is
+		 * removed from it.  See _rm_job_from_res().
+		 */
+		new_ptr[i].gres_list = gres_list;
+		new_ptr[i].gres_shared = true;
 	}
 	return new_use_ptr;
 }
 
+/* Log how many nodes a will_run test had to copy the GRES state of */
+static void _log_gres_copies(struct job_record *job_ptr,
+			     struct node_use_record *future_usage)
+{
+	int i, copy_cnt = 0;
+
+	for (i = 0; i < select_node_cnt; i++) {
+		if (!future_usage[i].gres_shared)
+			copy_cnt++;
+	}
+	info("cons_tres: will_run test of job %u copied GRES state of %d of %d "
+	     "nodes", job_ptr->job_id, copy_cnt, select_node_cnt);
+}
+
 /* Create a duplicate part_res_record list */
 static struct part_res_record *_dup_part_data(struct part_res_record *orig_ptr)
 {
@@ -1836,6 +1863,13 @@ static int _rm_job_from_res(struct part_res_record *part_record_ptr,
 
 		node_ptr = node_record_table_ptr + i;
 		if (action != 2) {
+			if (node_usage[i].gres_shared) {
+				/* Copy on first change, see _dup_node_usage */
+				node_usage[i].gres_list =
+					gres_plugin_node_state_dup(
+						node_usage[i].gres_list);
+				node_usage[i].gres_shared = false;
+			}
 			if (node_usage[i].gres_list)
 				gres_list = node_usage[i].gres_list;
 			else
@@ -3188,19 +3222,45 @@ static void _get_res_avail(struct job_record *job_ptr, bitstr_t *node_map,
 			   uint16_t cr_type, uint16_t **cpu_cnt_ptr,
 			   bool test_only, bitstr_t **part_core_map)
 {
-	uint16_t *cpu_cnt;
-	uint32_t n;
+	uint16_t *cpu_cnt, min_cpus, vpus;
+	uint32_t n, skip_cnt = 0;
 	uint32_t s_p_n = _socks_per_node(job_ptr);
+	struct job_details *details_ptr = job_ptr->details;
+
+	/*
+	 * Fewest CPUs a node must offer to hold even one of the job's tasks.
+	 * Nodes without enough free cores for that are skipped before the
+	 * GRES and core layout work in _can_job_run_on_node().
+	 */
+	if (details_ptr->overcommit)
+		min_cpus = 1;
+	else
+		min_cpus = MAX(details_ptr->cpus_per_task, 1);
 
 	cpu_cnt = xmalloc(sizeof(uint16_t) * select_node_cnt);
 	for (n = 0; n < select_node_cnt; n++) {
 		if (!bit_test(node_map, n))
 			continue;
+		vpus = MAX(select_node_record[n].vpus, 1);
+		if (!core_map[n] ||
+		    (bit_set_count(core_map[n]) <
+		     ((min_cpus + vpus - 1) / vpus))) {
+			if (core_map[n])
+				bit_clear_all(core_map[n]);
+			skip_cnt++;
+			continue;
+		}
 		cpu_cnt[n] = _can_job_run_on_node(job_ptr, core_map, n, s_p_n,
 						  node_usage, cr_type,
 						  test_only, part_core_map);
 	}
 	*cpu_cnt_ptr = cpu_cnt;
+
+	if (skip_cnt && (select_debug_flags & DEBUG_FLAG_SELECT_TYPE)) {
+		info("cons_tres: %s: job %u skipped %u nodes with fewer than "
+		     "%u free CPUs", __func__, job_ptr->job_id, skip_cnt,
+		     min_cpus);
+	}
 }
 
 /*
@@ -3981,6 +4041,8 @@ extern int will_run_test(struct job_record *job_ptr, bitstr_t *node_bitmap,
 		list_iterator_destroy(preemptee_iterator);
 	}
 
+	if (select_debug_flags & DEBUG_FLAG_SELECT_TYPE)
+		_log_gres_copies(job_ptr, future_usage);
 	FREE_NULL_LIST(cr_job_list);
 	cr_destroy_part_data(future_part);
 	cr_destroy_node_data(future_usage, NULL);
@@ -2327,7 +2327,8 @@ extern void cr_destroy_node_data(struct node_use_record *node_usage,
 	xfree(node_data);
 	if (node_usage) {
 		for (i = 0; i < select_node_cnt; i++) {
-			FREE_NULL_LIST(node_usage[i].gres_list);
+			if (!node_usage[i].gres_shared)
+				FREE_NULL_LIST(node_usage[i].gres_list);
 		}
 		xfree(node_usage);
 	}
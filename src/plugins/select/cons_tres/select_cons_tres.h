@@ -89,6 +89,9 @@ struct node_use_record {
 					 * defined in in src/common/gres.h.
 					 * Local data used only in state copy
 					 * to emulate future node state */
+	bool gres_shared;		/* gres_list belongs to the record this
+					 * one was copied from, copy it before
+					 * making any change */
 	uint16_t node_state;		/* see node_cr_state comments */
 };
 
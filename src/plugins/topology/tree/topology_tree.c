@@ -242,6 +242,8 @@ static void _find_child_switches (int sw)
 		for (i=0; i<switch_record_cnt; i++) {
 			if (xstrcmp(swname, switch_record_table[i].name) == 0) {
 				switch_record_table[sw].switch_index[cldx] = i;
+				if (switch_record_table[i].parent != NO_VAL16)
+					switch_tree_strict = false;
 				switch_record_table[i].parent = sw;
 				cldx++;
 				break;
@@ -403,6 +405,7 @@ static void _validate_switches(void)
 	/* Report nodes on multiple leaf switches,
 	 * possibly due to bad configuration file */
 	i = bit_set_count(multi_homed_bitmap);
+	switch_tree_strict = (i == 0) && (switch_record_cnt < NO_VAL16);
 	if (i > 0) {
 		child = bitmap2node_name(multi_homed_bitmap);
 		error("WARNING: Multiple leaf switches contain nodes: %s",
@@ -413,9 +416,13 @@ static void _validate_switches(void)
 
 	/* Create array of indexes of children of each switch,
 	 * and see if any switch can reach all nodes */
+	for (i = 0; i < switch_record_cnt; i++)
+		switch_record_table[i].parent = NO_VAL16;
 	for (i = 0; i < switch_record_cnt; i++) {
 		if (switch_record_table[i].level != 0) {
 			_find_child_switches (i);
+		} else {
+			switch_leaf_index_build(i);
 		}
 		if (node_record_count ==
 			bit_set_count(switch_record_table[i].node_bitmap)) {
@@ -474,11 +481,13 @@ static void _free_switch_record_table(void)
 			xfree(switch_record_table[i].nodes);
 			xfree(switch_record_table[i].switches);
 			xfree(switch_record_table[i].switch_index);
+			xfree(switch_record_table[i].node_index);
 			FREE_NULL_BITMAP(switch_record_table[i].node_bitmap);
 		}
 		xfree(switch_record_table);
 		switch_record_cnt = 0;
 		switch_levels = 0;
+		switch_tree_strict = false;
 	}
 }
 
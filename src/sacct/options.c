@@ -57,6 +57,9 @@
 
 #define JOB_HASH_SIZE 1000
 
+/* Number of jobs to get from the database at once */
+#define SACCT_PAGE_SIZE 10000
+
 static void _help_fields_msg(void);
 static void _help_msg(void);
 static void _init_params(void);
@@ -547,6 +550,18 @@ static void _remove_duplicate_fed_jobs(List jobs)
 	xfree(hash_job);
 }
 
+static slurmdb_job_rec_t *_last_job(List jobs)
+{
+	slurmdb_job_rec_t *job, *last_job = NULL;
+	ListIterator itr = list_iterator_create(jobs);
+
+	while ((job = list_next(itr)))
+		last_job = job;
+	list_iterator_destroy(itr);
+
+	return last_job;
+}
+
 extern int get_data(void)
 {
 	slurmdb_job_rec_t *job = NULL;
@@ -561,12 +576,31 @@ extern int get_data(void)
 		jobs = slurmdb_jobcomp_jobs_get(job_cond);
 		return SLURM_SUCCESS;
 	} else {
+		/*
+		 * Get and print the jobs a page at a time so neither we nor
+		 * the slurmdbd have to hold all of them. Removing duplicate
+		 * federated jobs needs all of them at once.
+		 */
+		if (!params.cluster_name ||
+		    (job_cond->flags & JOBCOND_FLAG_DUP))
+			job_cond->page_size = SACCT_PAGE_SIZE;
 		jobs = slurmdb_jobs_get(acct_db_conn, job_cond);
 	}
 
 	if (!jobs)
 		return SLURM_ERROR;
 
+	/*
+	 * A slurmdbd that doesn't know about pages sends all jobs again,
+	 * ending with the job we asked to continue after.
+	 */
+	if (job_cond->page_cluster && (job = _last_job(jobs)) &&
+	    (job->jobid == job_cond->page_jobid) &&
+	    !xstrcmp(job->cluster, job_cond->page_cluster)) {
+		list_flush(jobs);
+		return SLURM_SUCCESS;
+	}
+
 	/*
 	 * Remove duplicate federated jobs. The db will remove duplicates for
 	 * one cluster but not when jobs for multiple clusters are requested.
@@ -1320,6 +1354,28 @@ static inline bool _test_local_job(uint32_t job_id)
 	return false;
 }
 
+/* next_page() -- Set up the request for the next page of jobs
+ *
+ * RET true if there may be more jobs to get and print.
+ */
+extern bool next_page(void)
+{
+	slurmdb_job_cond_t *job_cond = params.job_cond;
+	slurmdb_job_rec_t *job;
+
+	if (params.opt_completion || !job_cond->page_size || !jobs ||
+	    (list_count(jobs) < job_cond->page_size) ||
+	    !(job = _last_job(jobs)))
+		return false;
+
+	xfree(job_cond->page_cluster);
+	job_cond->page_cluster = xstrdup(job->cluster);
+	job_cond->page_jobid = job->jobid;
+	FREE_NULL_LIST(jobs);
+
+	return true;
+}
+
 /* do_list() -- List the assembled data
  *
  * In:	Nothing explicit.
@@ -229,6 +229,7 @@ void parse_command_line(int argc, char **argv);
 void do_help(void);
 void do_list(void);
 void do_list_completion(void);
+bool next_page(void);
 void sacct_init(void);
 void sacct_fini(void);
 
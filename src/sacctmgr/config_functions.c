@@ -196,6 +196,23 @@ extern int sacctmgr_list_stats(int argc, char **argv)
 		       buf->rollup_max_time[i], buf->rollup_time[i]);
 	}
 
+	if (buf->lane_cnt) {	/* Not sent by older slurmdbd */
+		printf("\nRPC lane statistics\n");
+		for (i = 0; i < SLURMDB_LANE_COUNT; i++) {
+			roll_ave = buf->lane_time[i];
+			if (buf->lane_cnt[i] > 1)
+				roll_ave /= buf->lane_cnt[i];
+			printf("\t%-10s count:%-6u ave_time:%-6"PRIu64
+			       " max_time:%-12"PRIu64
+			       " total_time:%-12"PRIu64
+			       " wait_time:%-12"PRIu64"\n",
+			       (i == SLURMDB_LANE_CTLD) ? "slurmctld" : "user",
+			       buf->lane_cnt[i], roll_ave,
+			       buf->lane_max_time[i], buf->lane_time[i],
+			       buf->lane_wait_time[i]);
+		}
+	}
+
 	if (argc) {
 		if (!xstrncasecmp(argv[0], "ave_time", 2))
 			sort_by_ave_time = true;
@@ -56,6 +56,7 @@
 
 #define OPT_LONG_HELP   0x100
 #define OPT_LONG_USAGE  0x101
+#define OPT_LONG_STREAMS 0x102
 
 /* getopt_long options, integers but not characters */
 
@@ -81,6 +82,7 @@ extern void parse_command_line(int argc, char **argv)
 		{"jobid",     required_argument, 0, 'j'},
 		{"preserve",  no_argument,       0, 'p'},
 		{"size",      required_argument, 0, 's'},
+		{"streams",   required_argument, 0, OPT_LONG_STREAMS},
 		{"timeout",   required_argument, 0, 't'},
 		{"verbose",   no_argument,       0, 'v'},
 		{"version",   no_argument,       0, 'V'},
@@ -117,6 +119,8 @@ extern void parse_command_line(int argc, char **argv)
 		params.block_size = _map_size(env_val);
 	else
 		params.block_size = 8 * 1024 * 1024;
+	if ( ( env_val = getenv("SBCAST_STREAMS") ) )
+		params.streams = atoi(env_val);
 	if ( ( env_val = getenv("SBCAST_TIMEOUT") ) )
 		params.timeout = (atoi(env_val) * 1000);
 
@@ -153,6 +157,9 @@ extern void parse_command_line(int argc, char **argv)
 		case (int) 's':
 			params.block_size = _map_size(optarg);
 			break;
+		case (int) OPT_LONG_STREAMS:
+			params.streams = atoi(optarg);
+			break;
 		case (int)'t':
 			params.timeout = (atoi(optarg) * 1000);
 			break;
@@ -269,6 +276,7 @@ static void _print_options( void )
 		}
 	}
 	info("preserve   = %s", params.preserve ? "true" : "false");
+	info("streams    = %d", params.streams);
 	info("timeout    = %d", params.timeout);
 	info("verbose    = %d", params.verbose);
 	info("source     = %s", params.src_fname);
@@ -292,6 +300,7 @@ Usage: sbcast [OPTIONS] SOURCE DEST\n\
   -j, --jobid=#[+#][.#] specify job ID with optional pack job offset and/or step ID\n\
   -p, --preserve        preserve modes and times of source file\n\
   -s, --size=num        block size in bytes (rounded off)\n\
+      --streams=num     number of blocks to transmit concurrently\n\
   -t, --timeout=secs    specify message timeout (seconds)\n\
   -v, --verbose         provide detailed event logging\n\
   -V, --version         print version information and exit\n\
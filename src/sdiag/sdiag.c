@@ -147,6 +147,30 @@ static int _print_stats(void)
 		       ((buf->req_time - buf->req_time_start) / 60)));
 	}
 	printf("\tLast queue length: %u\n", buf->schedule_queue_len);
+	printf("\tSingle node fast path starts: %u\n",
+	       buf->schedule_fast_path);
+	printf("\tJob steps created: %u\n", buf->steps_created);
+	if (buf->steps_created > 0) {
+		printf("\tMean step creation time: %"PRIu64" usec\n",
+		       buf->step_create_time_sum / buf->steps_created);
+		printf("\tMax step creation time:  %u usec\n",
+		       buf->step_create_time_max);
+	}
+	printf("\tPreemption candidate searches: %u\n",
+	       buf->preempt_find_cnt);
+	if (buf->preempt_find_cnt > 0) {
+		printf("\tMean preemption search time: %"PRIu64" usec\n",
+		       buf->preempt_find_time_sum / buf->preempt_find_cnt);
+		printf("\tMax preemption search time:  %u usec\n",
+		       buf->preempt_find_time_max);
+	}
+	printf("\tReservation tests: %u\n", buf->resv_test_cnt);
+	if (buf->resv_test_cnt > 0) {
+		printf("\tMean reservation test time: %"PRIu64" usec\n",
+		       buf->resv_test_time_sum / buf->resv_test_cnt);
+		printf("\tMax reservation test time:  %u usec\n",
+		       buf->resv_test_time_max);
+	}
 
 	if (buf->bf_active) {
 		printf("\nBackfilling stats (WARNING: data obtained"
@@ -4613,6 +4613,36 @@ static int _sort_part_tier(void *x, void *y)
 	return 0;
 }
 
+/*
+ * Return 1 if partition y would give the same node selection result as
+ * partition x: same nodes and same settings used by select_nodes() and the
+ * select plugin. Limits only checked by job_limits_check() may differ.
+ */
+static int _find_part_sched_match(void *x, void *y)
+{
+	struct part_record *parta = (struct part_record *) x;
+	struct part_record *partb = (struct part_record *) y;
+
+	if (!bit_equal(parta->node_bitmap, partb->node_bitmap) ||
+	    (parta->flags != partb->flags) ||
+	    (parta->cr_type != partb->cr_type) ||
+	    (parta->max_share != partb->max_share) ||
+	    (parta->preempt_mode != partb->preempt_mode) ||
+	    (parta->priority_tier != partb->priority_tier) ||
+	    (parta->qos_ptr != partb->qos_ptr) ||
+	    (parta->def_mem_per_cpu != partb->def_mem_per_cpu) ||
+	    (parta->max_mem_per_cpu != partb->max_mem_per_cpu) ||
+	    (parta->max_cpus_per_node != partb->max_cpus_per_node) ||
+	    (parta->min_nodes != partb->min_nodes) ||
+	    (parta->max_nodes != partb->max_nodes) ||
+	    (parta->default_time != partb->default_time) ||
+	    (parta->max_time != partb->max_time) ||
+	    parta->job_defaults_list || partb->job_defaults_list)
+		return 0;
+
+	return 1;
+}
+
 /*
  * Wrapper for select_nodes() function that will test all valid partitions
  * for a new job
@@ -4627,8 +4657,9 @@ static int _sort_part_tier(void *x, void *y)
 static int _select_nodes_parts(struct job_record *job_ptr, bool test_only,
 			       bitstr_t **select_node_bitmap, char **err_msg)
 {
-	struct part_record *part_ptr;
+	struct part_record *part_ptr, *busy_part_ptr;
 	ListIterator iter;
+	List busy_part_list = NULL;
 	int rc = ESLURM_REQUESTED_PART_CONFIG_UNAVAILABLE;
 	int best_rc = -1, part_limits_rc = WAIT_NO_REASON;
 
@@ -4657,10 +4688,31 @@ static int _select_nodes_parts(struct job_record *job_ptr, bool test_only,
 				}
 			}
 
-			if (part_limits_rc == WAIT_NO_REASON) {
+			/*
+			 * A partition with the same nodes and scheduling
+			 * settings as one where the job was just found busy
+			 * would repeat the same full node selection test.
+			 */
+			if ((part_limits_rc == WAIT_NO_REASON) &&
+			    busy_part_list &&
+			    (busy_part_ptr = list_find_first(busy_part_list,
+						_find_part_sched_match,
+						part_ptr))) {
+				debug2("Job %u busy in partition %s, same as %s",
+				       job_ptr->job_id, part_ptr->name,
+				       busy_part_ptr->name);
+				rc = ESLURM_NODES_BUSY;
+			} else if (part_limits_rc == WAIT_NO_REASON) {
 				rc = select_nodes(job_ptr, test_only,
 						  select_node_bitmap, err_msg,
 						  true);
+				if ((rc == ESLURM_NODES_BUSY) &&
+				    !job_ptr->preempt_in_progress) {
+					if (!busy_part_list)
+						busy_part_list =
+							list_create(NULL);
+					list_append(busy_part_list, part_ptr);
+				}
 			} else {
 				rc = select_nodes(job_ptr, true,
 						  select_node_bitmap, err_msg,
@@ -4708,6 +4760,7 @@ static int _select_nodes_parts(struct job_record *job_ptr, bool test_only,
 			}
 		}
 		list_iterator_destroy(iter);
+		FREE_NULL_LIST(busy_part_list);
 		if (best_rc != -1)
 			rc = best_rc;
 		else if (part_limits_rc == WAIT_PART_DOWN)
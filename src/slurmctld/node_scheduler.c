@@ -101,6 +101,13 @@ struct node_set {		/* set of nodes with same configuration */
 	bitstr_t *my_bitmap;		/* node bitmap */
 };
 
+/*
+ * Set when the nodes of the job being selected came from
+ * _serial_fast_path(), counted once select_nodes() starts the job.
+ * Protected by the job write lock.
+ */
+static bool serial_fast_picked = false;
+
 static int  _build_node_list(struct job_record *job_ptr,
 			     struct node_set **node_set_pptr,
 			     int *node_set_size, char **err_msg,
@@ -628,6 +635,50 @@ extern void deallocate_nodes(struct job_record *job_ptr, bool timeout,
 	return;
 }
 
+/*
+ * Set *dest to a copy of src, or to an empty bitmap if src is NULL. An
+ * existing *dest of the right size is reused rather than reallocated.
+ */
+static void _copy_feature_bitmap(bitstr_t **dest, bitstr_t *src)
+{
+	int size = src ? bit_size(src) : node_record_count;
+
+	if (*dest && (bit_size(*dest) != size))
+		FREE_NULL_BITMAP(*dest);
+	if (!*dest)
+		*dest = bit_alloc(size);
+	if (src)
+		bit_copybits(*dest, src);
+	else
+		bit_clear_all(*dest);
+}
+
+static void _log_feature_nodes(job_feature_t *job_feat_ptr)
+{
+	char *tmp1, *tmp2, *tmp3, *tmp4 = NULL;
+
+	if (job_feat_ptr->op_code == FEATURE_OP_OR)
+		tmp3 = "OR";
+	else if (job_feat_ptr->op_code == FEATURE_OP_AND)
+		tmp3 = "AND";
+	else if (job_feat_ptr->op_code == FEATURE_OP_XOR)
+		tmp3 = "XOR";
+	else if (job_feat_ptr->op_code == FEATURE_OP_XAND)
+		tmp3 = "XAND";
+	else {
+		xstrfmtcat(tmp4, "OTHER:%u", job_feat_ptr->op_code);
+		tmp3 = tmp4;
+	}
+	tmp1 = bitmap2node_name(job_feat_ptr->node_bitmap_active);
+	tmp2 = bitmap2node_name(job_feat_ptr->node_bitmap_avail);
+	info("find_feature_nodes: FEAT:%s COUNT:%u PAREN:%d OP:%s ACTIVE:%s AVAIL:%s",
+	     job_feat_ptr->name, job_feat_ptr->count,
+	     job_feat_ptr->paren, tmp3, tmp1, tmp2);
+	xfree(tmp1);
+	xfree(tmp2);
+	xfree(tmp4);
+}
+
 /*
  * For every element in the feature_list, identify the nodes with that feature
  * either active or available and set the feature_list's node_bitmap_active and
@@ -638,64 +689,35 @@ extern void find_feature_nodes(List feature_list, bool can_reboot)
 	ListIterator feat_iter;
 	job_feature_t  *job_feat_ptr;
 	node_feature_t *node_feat_ptr;
+	bool log_features;
 
 	if (!feature_list)
 		return;
+	log_features = slurmctld_conf.debug_flags & DEBUG_FLAG_NODE_FEATURES;
 	feat_iter = list_iterator_create(feature_list);
 	while ((job_feat_ptr = (job_feature_t *) list_next(feat_iter))) {
-		FREE_NULL_BITMAP(job_feat_ptr->node_bitmap_active);
-		FREE_NULL_BITMAP(job_feat_ptr->node_bitmap_avail);
 		node_feat_ptr = list_find_first(active_feature_list,
 						list_find_feature,
 						job_feat_ptr->name);
-		if (node_feat_ptr && node_feat_ptr->node_bitmap) {
-			job_feat_ptr->node_bitmap_active =
-				bit_copy(node_feat_ptr->node_bitmap);
-		} else {	/* This feature not active */
-			job_feat_ptr->node_bitmap_active =
-				bit_alloc(node_record_count);
-		}
+		/* NULL if this feature is not active */
+		_copy_feature_bitmap(&job_feat_ptr->node_bitmap_active,
+				     node_feat_ptr ?
+				     node_feat_ptr->node_bitmap : NULL);
 		if (can_reboot &&
 		    node_features_g_changeable_feature(job_feat_ptr->name)) {
 			node_feat_ptr = list_find_first(avail_feature_list,
 							list_find_feature,
 							job_feat_ptr->name);
-			if (node_feat_ptr && node_feat_ptr->node_bitmap) {
-				job_feat_ptr->node_bitmap_avail =
-					bit_copy(node_feat_ptr->node_bitmap);
-			} else {   /* This feature not available */
-				job_feat_ptr->node_bitmap_avail =
-					bit_alloc(node_record_count);
-			}
-		} else if (job_feat_ptr->node_bitmap_active) {
-			job_feat_ptr->node_bitmap_avail =
-				bit_copy(job_feat_ptr->node_bitmap_active);
-		}
-#if 1
-{
-		char *tmp1, *tmp2, *tmp3, *tmp4 = NULL;
-		if (job_feat_ptr->op_code == FEATURE_OP_OR)
-			tmp3 = "OR";
-		else if (job_feat_ptr->op_code == FEATURE_OP_AND)
-			tmp3 = "AND";
-		else if (job_feat_ptr->op_code == FEATURE_OP_XOR)
-			tmp3 = "XOR";
-		else if (job_feat_ptr->op_code == FEATURE_OP_XAND)
-			tmp3 = "XAND";
-		else {
-			xstrfmtcat(tmp4, "OTHER:%u", job_feat_ptr->op_code);
-			tmp3 = tmp4;
+			/* NULL if this feature is not available */
+			_copy_feature_bitmap(&job_feat_ptr->node_bitmap_avail,
+					     node_feat_ptr ?
+					     node_feat_ptr->node_bitmap : NULL);
+		} else {
+			_copy_feature_bitmap(&job_feat_ptr->node_bitmap_avail,
+					     job_feat_ptr->node_bitmap_active);
 		}
-		tmp1 = bitmap2node_name(job_feat_ptr->node_bitmap_active);
-		tmp2 = bitmap2node_name(job_feat_ptr->node_bitmap_avail);
-		info("%s: FEAT:%s COUNT:%u PAREN:%d OP:%s ACTIVE:%s AVAIL:%s",
-		     __func__, job_feat_ptr->name, job_feat_ptr->count,
-		     job_feat_ptr->paren, tmp3, tmp1, tmp2);
-		xfree(tmp1);
-		xfree(tmp2);
-		xfree(tmp4);
-}
-#endif
+		if (log_features)
+			_log_feature_nodes(job_feat_ptr);
 	}
 	list_iterator_destroy(feat_iter);
 }
@@ -1687,6 +1709,63 @@ _get_req_features(struct node_set *node_set_ptr, int node_set_size,
  *	   DRAINED or ALLOCATED) to determine if the request can
  *         ever be satisfied.
  */
+/*
+ * Return true if the job can use the single node fast path: it needs one
+ * node, is about to be started, has no required nodes or features, and
+ * isn't placed by least loaded node (which the hint would defeat).
+ */
+static bool _serial_fast_path_ok(struct job_record *job_ptr,
+				 struct part_record *part_ptr,
+				 uint32_t min_nodes, uint32_t max_nodes,
+				 int select_mode, List preemptee_candidates)
+{
+	struct job_details *detail_ptr = job_ptr->details;
+
+	if ((select_mode != SELECT_MODE_RUN_NOW) ||
+	    (min_nodes != 1) || (max_nodes != 1) || preemptee_candidates)
+		return false;
+	if (detail_ptr->req_node_bitmap || detail_ptr->feature_list)
+		return false;
+	if ((part_ptr->flags & PART_FLAG_LLN) ||
+	    (slurmctld_conf.select_type_param & CR_LLN))
+		return false;
+
+	return true;
+}
+
+/*
+ * Single node fast path: before testing every node in avail_bitmap, try
+ * the node the previous single node job of this partition was placed on.
+ * A stream of small jobs keeps filling that node with a one node
+ * select_g_job_test() call each until it is full.
+ * RET bitmap of the selected node or NULL if the full test is needed
+ */
+static bitstr_t *_serial_fast_path(struct job_record *job_ptr,
+				   struct part_record *part_ptr,
+				   bitstr_t *avail_bitmap,
+				   List *preemptee_job_list,
+				   bitstr_t *exc_core_bitmap)
+{
+	bitstr_t *hint_bitmap;
+	int inx = part_ptr->serial_node_hint - 1;
+
+	if ((inx < 0) || (inx >= bit_size(avail_bitmap)) ||
+	    !bit_test(avail_bitmap, inx))
+		return NULL;
+
+	hint_bitmap = bit_alloc(bit_size(avail_bitmap));
+	bit_set(hint_bitmap, inx);
+	if (select_g_job_test(job_ptr, hint_bitmap, 1, 1, 1,
+			      SELECT_MODE_RUN_NOW, NULL, preemptee_job_list,
+			      exc_core_bitmap) == SLURM_SUCCESS) {
+		serial_fast_picked = true;
+		return hint_bitmap;
+	}
+
+	FREE_NULL_BITMAP(hint_bitmap);
+	return NULL;
+}
+
 static int
 _pick_best_nodes(struct node_set *node_set_ptr, int node_set_size,
 		 bitstr_t ** select_bitmap, struct job_record *job_ptr,
@@ -1709,6 +1788,7 @@ _pick_best_nodes(struct node_set *node_set_ptr, int node_set_size,
 	static uint32_t cr_enabled = NO_VAL;
 	bool preempt_flag = false;
 	bool nodes_busy = false;
+	bool serial_fast = false;
 	int shared = 0, select_mode;
 	List preemptee_cand;
 
@@ -1775,6 +1855,12 @@ _pick_best_nodes(struct node_set *node_set_ptr, int node_set_size,
 					cr_enabled);
 	if (cr_enabled)
 		job_ptr->cr_enabled = cr_enabled; /* CR enabled for this job */
+	if (cr_enabled) {
+		serial_fast = _serial_fast_path_ok(job_ptr, part_ptr,
+						   min_nodes, max_nodes,
+						   select_mode,
+						   preemptee_candidates);
+	}
 
 	/*
 	 * If job preemption is enabled, then do NOT limit the set of available
@@ -1978,6 +2064,19 @@ _pick_best_nodes(struct node_set *node_set_ptr, int node_set_size,
 				preemptee_cand = preemptee_candidates;
 
 			job_ptr->details->pn_min_memory = orig_req_mem;
+			if (serial_fast) {
+				bitstr_t *hint_bitmap = _serial_fast_path(
+					job_ptr, part_ptr, avail_bitmap,
+					preemptee_job_list, exc_core_bitmap);
+				if (hint_bitmap) {
+					FREE_NULL_BITMAP(avail_bitmap);
+					FREE_NULL_BITMAP(backup_bitmap);
+					FREE_NULL_BITMAP(total_bitmap);
+					FREE_NULL_BITMAP(possible_bitmap);
+					*select_bitmap = hint_bitmap;
+					return SLURM_SUCCESS;
+				}
+			}
 			pick_code = select_g_job_test(job_ptr,
 						      avail_bitmap,
 						      min_nodes,
@@ -2019,6 +2118,10 @@ _pick_best_nodes(struct node_set *node_set_ptr, int node_set_size,
 				}
 				FREE_NULL_BITMAP(total_bitmap);
 				FREE_NULL_BITMAP(possible_bitmap);
+				if (serial_fast) {
+					part_ptr->serial_node_hint =
+						bit_ffs(avail_bitmap) + 1;
+				}
 				*select_bitmap = avail_bitmap;
 				return SLURM_SUCCESS;
 			} else {
@@ -2058,6 +2161,10 @@ _pick_best_nodes(struct node_set *node_set_ptr, int node_set_size,
 			     (bit_set_count(avail_bitmap) <= max_nodes)) {
 				FREE_NULL_BITMAP(total_bitmap);
 				FREE_NULL_BITMAP(possible_bitmap);
+				if (serial_fast) {
+					part_ptr->serial_node_hint =
+						bit_ffs(avail_bitmap) + 1;
+				}
 				*select_bitmap = avail_bitmap;
 				return SLURM_SUCCESS;
 			}
@@ -2444,6 +2551,8 @@ extern int select_nodes(struct job_record *job_ptr, bool test_only,
 	xassert(job_ptr);
 	xassert(job_ptr->magic == JOB_MAGIC);
 
+	serial_fast_picked = false;
+
 	if (!acct_policy_job_runnable_pre_select(job_ptr, false))
 		return ESLURM_ACCOUNTING_POLICY;
 
@@ -2850,6 +2959,8 @@ extern int select_nodes(struct job_record *job_ptr, bool test_only,
 		mail_job_info(job_ptr, MAIL_JOB_BEGIN);
 
 	slurmctld_diag_stats.jobs_started++;
+	if (serial_fast_picked)
+		slurmctld_diag_stats.schedule_fast_path++;
 
 	/* job_set_alloc_tres has to be done before acct_policy_job_begin */
 	job_set_alloc_tres(job_ptr, false);
@@ -43,6 +43,7 @@
 #include "src/common/log.h"
 #include "src/common/plugrack.h"
 #include "src/common/slurm_protocol_api.h"
+#include "src/common/timers.h"
 #include "src/common/xmalloc.h"
 #include "src/common/xstring.h"
 #include "src/slurmctld/slurmctld.h"
@@ -182,10 +183,21 @@ extern int slurm_preempt_fini(void)
 
 extern List slurm_find_preemptable_jobs(struct job_record *job_ptr)
 {
+	List preemptee_job_list;
+	DEF_TIMERS;
+
 	if (slurm_preempt_init() < 0)
 		return NULL;
 
-	return (*(ops.find_jobs))(job_ptr);
+	START_TIMER;
+	preemptee_job_list = (*(ops.find_jobs))(job_ptr);
+	END_TIMER;
+	slurmctld_diag_stats.preempt_find_cnt++;
+	slurmctld_diag_stats.preempt_find_time_sum += DELTA_TIMER;
+	slurmctld_diag_stats.preempt_find_time_max =
+		MAX(slurmctld_diag_stats.preempt_find_time_max, DELTA_TIMER);
+
+	return preemptee_job_list;
 }
 
 /*
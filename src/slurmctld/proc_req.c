@@ -1892,7 +1892,12 @@ static void  _slurm_rpc_get_shares(slurm_msg_t *msg)
 	response_msg.data     = &resp_msg;
 	slurm_send_node_msg(msg->conn_fd, &response_msg);
 	FREE_NULL_LIST(resp_msg.assoc_shares_list);
-	/* don't free the resp_msg.tres_names */
+	if (resp_msg.tres_names) {
+		int i;
+		for (i = 0; i < resp_msg.tres_cnt; i++)
+			xfree(resp_msg.tres_names[i]);
+		xfree(resp_msg.tres_names);
+	}
 	END_TIMER2("_slurm_rpc_get_share");
 	debug2("_slurm_rpc_get_shares %s", TIME_STR);
 }
@@ -2791,6 +2796,14 @@ static void _slurm_rpc_job_step_create(slurm_msg_t * msg)
 		ext_sensors_g_get_stepstartdata(step_rec);
 	}
 	END_TIMER2("_slurm_rpc_job_step_create");
+	if (error_code == SLURM_SUCCESS) {
+		/* Includes time waiting for the job write lock */
+		slurmctld_diag_stats.steps_created++;
+		slurmctld_diag_stats.step_create_time_sum += DELTA_TIMER;
+		slurmctld_diag_stats.step_create_time_max =
+			MAX(slurmctld_diag_stats.step_create_time_max,
+			    DELTA_TIMER);
+	}
 
 	/* return result */
 	if (error_code) {
@@ -5090,10 +5090,10 @@ extern uint32_t job_test_watts_resv(struct job_record *job_ptr, time_t when,
  *	ESLURM_NODES_BUSY job has no reservation, but required nodes are
  *			  reserved
  */
-extern int job_test_resv(struct job_record *job_ptr, time_t *when,
-			 bool move_time, bitstr_t **node_bitmap,
-			 bitstr_t **exc_core_bitmap, bool *resv_overlap,
-			 bool reboot)
+static int _job_test_resv(struct job_record *job_ptr, time_t *when,
+			  bool move_time, bitstr_t **node_bitmap,
+			  bitstr_t **exc_core_bitmap, bool *resv_overlap,
+			  bool reboot)
 {
 	slurmctld_resv_t *resv_ptr = NULL, *res2_ptr;
 	time_t job_start_time, job_end_time, lic_resv_time;
@@ -5346,6 +5346,30 @@ extern int job_test_resv(struct job_record *job_ptr, time_t *when,
 	return rc;
 }
 
+/*
+ * Determine which nodes a job can use based upon reservations, see
+ * _job_test_resv() for the arguments. The time spent is reported by sdiag.
+ */
+extern int job_test_resv(struct job_record *job_ptr, time_t *when,
+			 bool move_time, bitstr_t **node_bitmap,
+			 bitstr_t **exc_core_bitmap, bool *resv_overlap,
+			 bool reboot)
+{
+	int rc;
+	DEF_TIMERS;
+
+	START_TIMER;
+	rc = _job_test_resv(job_ptr, when, move_time, node_bitmap,
+			    exc_core_bitmap, resv_overlap, reboot);
+	END_TIMER;
+	slurmctld_diag_stats.resv_test_cnt++;
+	slurmctld_diag_stats.resv_test_time_sum += DELTA_TIMER;
+	slurmctld_diag_stats.resv_test_time_max =
+		MAX(slurmctld_diag_stats.resv_test_time_max, DELTA_TIMER);
+
+	return rc;
+}
+
 /*
  * Determine the time of the first reservation to end after some time.
  * return zero of no reservation ends after that time.
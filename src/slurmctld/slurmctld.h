@@ -165,6 +165,19 @@ typedef struct diag_stats {
 	uint32_t schedule_cycle_counter;
 	uint32_t schedule_cycle_depth;
 	uint32_t schedule_queue_len;
+	uint32_t schedule_fast_path;
+
+	uint32_t steps_created;
+	uint32_t step_create_time_max;
+	uint64_t step_create_time_sum;
+
+	uint32_t preempt_find_cnt;
+	uint32_t preempt_find_time_max;
+	uint64_t preempt_find_time_sum;
+
+	uint32_t resv_test_cnt;
+	uint32_t resv_test_time_max;
+	uint64_t resv_test_time_sum;
 
 	uint32_t jobs_submitted;
 	uint32_t jobs_started;
@@ -378,6 +391,9 @@ struct part_record {
 	slurmdb_qos_rec_t *qos_ptr; /* pointer to the quality of
 				     * service record attached to this
 				     * partition confirm the value before use */
+	int serial_node_hint;	/* index + 1 of the node the last single
+				 * node job was placed on, 0 if none.
+				 * See _serial_fast_path() (DON'T PACK) */
 	uint16_t state_up;	/* See PARTITION_* states in slurm.h */
 	uint32_t total_nodes;	/* total number of nodes in the partition */
 	uint32_t total_cpus;	/* total number of cpus in the partition */
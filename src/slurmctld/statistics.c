@@ -131,6 +131,23 @@ extern void pack_all_stat(int resp, char **buffer_ptr, int *buffer_size,
 			pack32(slurmctld_diag_stats.bf_active, buffer);
 			pack32(slurmctld_diag_stats.backfilled_pack_jobs,
 			       buffer);
+			pack32(slurmctld_diag_stats.schedule_fast_path,
+			       buffer);
+			pack32(slurmctld_diag_stats.steps_created, buffer);
+			pack32(slurmctld_diag_stats.step_create_time_max,
+			       buffer);
+			pack64(slurmctld_diag_stats.step_create_time_sum,
+			       buffer);
+			pack32(slurmctld_diag_stats.preempt_find_cnt, buffer);
+			pack32(slurmctld_diag_stats.preempt_find_time_max,
+			       buffer);
+			pack64(slurmctld_diag_stats.preempt_find_time_sum,
+			       buffer);
+			pack32(slurmctld_diag_stats.resv_test_cnt, buffer);
+			pack32(slurmctld_diag_stats.resv_test_time_max,
+			       buffer);
+			pack64(slurmctld_diag_stats.resv_test_time_sum,
+			       buffer);
 		}
 	} else if (protocol_version >= SLURM_17_11_PROTOCOL_VERSION) {
 		parts_packed = resp;
@@ -263,6 +280,16 @@ extern void reset_stats(int level)
 	slurmctld_diag_stats.schedule_cycle_sum = 0;
 	slurmctld_diag_stats.schedule_cycle_counter = 0;
 	slurmctld_diag_stats.schedule_cycle_depth = 0;
+	slurmctld_diag_stats.schedule_fast_path = 0;
+	slurmctld_diag_stats.steps_created = 0;
+	slurmctld_diag_stats.step_create_time_max = 0;
+	slurmctld_diag_stats.step_create_time_sum = 0;
+	slurmctld_diag_stats.preempt_find_cnt = 0;
+	slurmctld_diag_stats.preempt_find_time_max = 0;
+	slurmctld_diag_stats.preempt_find_time_sum = 0;
+	slurmctld_diag_stats.resv_test_cnt = 0;
+	slurmctld_diag_stats.resv_test_time_max = 0;
+	slurmctld_diag_stats.resv_test_time_sum = 0;
 	slurmctld_diag_stats.jobs_submitted = 0;
 	slurmctld_diag_stats.jobs_started = 0;
 	slurmctld_diag_stats.jobs_completed = 0;
@@ -1079,14 +1079,17 @@ _pick_step_nodes (struct job_record  *job_ptr,
 		step_spec->pn_min_memory = 0;	/* clear MEM_PER_CPU flag */
 
 	if (job_ptr->next_step_id == 0) {
+		int i_first, i_last;
+
 		if (job_ptr->details && job_ptr->details->prolog_running) {
 			*return_code = ESLURM_PROLOG_RUNNING;
 			FREE_NULL_BITMAP(nodes_avail);
 			FREE_NULL_BITMAP(select_nodes_avail);
 			return NULL;
 		}
-		for (i=bit_ffs(job_ptr->node_bitmap); i<node_record_count;
-		     i++) {
+		i_first = bit_ffs(job_ptr->node_bitmap);
+		i_last = bit_fls(job_ptr->node_bitmap);
+		for (i = i_first; ((i <= i_last) && (i_first >= 0)); i++) {
 			if (!bit_test(job_ptr->node_bitmap, i))
 				continue;
 			node_ptr = node_record_table_ptr + i;
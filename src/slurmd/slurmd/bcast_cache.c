@@ -0,0 +1,365 @@
+/*****************************************************************************\
+ *  bcast_cache.c - sbcast content addressed block cache
+ *****************************************************************************
+ *  Copyright (C) 2018 SchedMD LLC.
+ *
+ *  This file is part of Slurm, a resource management program.
+ *  For details, see <https://slurm.schedmd.com/>.
+ *  Please also read the included file: DISCLAIMER.
+ *
+ *  Slurm is free software; you can redistribute it and/or modify it under
+ *  the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  In addition, as a special exception, the copyright holders give permission
+ *  to link the code of portions of this program with the OpenSSL library under
+ *  certain conditions as described in each individual source file, and
+ *  distribute linked combinations including the two. You must obey the GNU
+ *  General Public License in all respects for all of the code used other than
+ *  OpenSSL. If you modify file(s) with this exception, you may extend this
+ *  exception to your version of the file(s), but you are not obligated to do
+ *  so. If you do not wish to do so, delete this exception statement from your
+ *  version.  If you delete this exception statement from all source files in
+ *  the program, then also delete it here.
+ *
+ *  Slurm is distributed in the hope that it will be useful, but WITHOUT ANY
+ *  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *  FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ *  details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with Slurm; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA.
+\*****************************************************************************/
+
+#include "config.h"
+
+#include <ctype.h>
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include "slurm/slurm_errno.h"
+#include "src/common/list.h"
+#include "src/common/log.h"
+#include "src/common/macros.h"
+#include "src/common/proc_args.h"
+#include "src/common/slurm_protocol_api.h"
+#include "src/common/xmalloc.h"
+#include "src/common/xstring.h"
+
+#include "src/bcast/sha256.h"
+#include "src/slurmd/slurmd/bcast_cache.h"
+
+#define DEFAULT_CACHE_SIZE	10240	/* MB */
+
+typedef struct {
+	char *path;
+	time_t mtime;
+	uint64_t size;
+} cache_entry_t;
+
+static pthread_mutex_t cache_mutex = PTHREAD_MUTEX_INITIALIZER;
+static char *cache_dir = NULL;		/* NULL if caching is disabled */
+static uint64_t cache_limit = 0;	/* bytes */
+static uint64_t cache_used = 0;		/* bytes, as of last scan or store */
+
+/* Return the value of "key=" in SbcastParameters, xfree() the result */
+static char *_get_param(char *params, char *key)
+{
+	char *tmp, *sep, *val = NULL;
+
+	if (!params || !(tmp = xstrcasestr(params, key)))
+		return NULL;
+	val = xstrdup(tmp + strlen(key));
+	if ((sep = strchr(val, ',')))
+		sep[0] = '\0';
+	return val;
+}
+
+/* Valid hashes are exactly SHA256_HEX_LEN-1 lower case hex digits */
+static bool _valid_hash(char *hash)
+{
+	int i;
+
+	if (!hash)
+		return false;
+	for (i = 0; i < (SHA256_HEX_LEN - 1); i++) {
+		if (!isxdigit((int) hash[i]) || isupper((int) hash[i]))
+			return false;
+	}
+	return (hash[i] == '\0');
+}
+
+static void _free_entry(void *x)
+{
+	cache_entry_t *entry = (cache_entry_t *) x;
+
+	if (!entry)
+		return;
+	xfree(entry->path);
+	xfree(entry);
+}
+
+static int _sort_by_mtime(void *x, void *y)
+{
+	cache_entry_t *e1 = *(cache_entry_t **) x;
+	cache_entry_t *e2 = *(cache_entry_t **) y;
+
+	if (e1->mtime < e2->mtime)
+		return -1;
+	if (e1->mtime > e2->mtime)
+		return 1;
+	return 0;
+}
+
+/*
+ * Walk every user's directory and record the cached blocks
+ * IN entries - List to fill, or NULL to only sum up block sizes
+ * RET total size of the cached blocks in bytes
+ * cache_mutex must be locked
+ */
+static uint64_t _scan_cache(List entries)
+{
+	DIR *top_dir, *user_dir;
+	struct dirent *top_ent, *ent;
+	struct stat st;
+	cache_entry_t *entry;
+	char *user_path, *path;
+	uint64_t total = 0;
+
+	if (!(top_dir = opendir(cache_dir))) {
+		error("%s: opendir(%s): %m", __func__, cache_dir);
+		return 0;
+	}
+	while ((top_ent = readdir(top_dir))) {
+		if (top_ent->d_name[0] == '.')
+			continue;
+		user_path = xstrdup_printf("%s/%s", cache_dir,
+					   top_ent->d_name);
+		if (!(user_dir = opendir(user_path))) {
+			xfree(user_path);
+			continue;
+		}
+		while ((ent = readdir(user_dir))) {
+			if (!_valid_hash(ent->d_name))
+				continue;
+			path = xstrdup_printf("%s/%s", user_path, ent->d_name);
+			if (stat(path, &st) || !S_ISREG(st.st_mode)) {
+				xfree(path);
+				continue;
+			}
+			total += st.st_size;
+			if (!entries) {
+				xfree(path);
+				continue;
+			}
+			entry = xmalloc(sizeof(cache_entry_t));
+			entry->path = path;
+			entry->mtime = st.st_mtime;
+			entry->size = st.st_size;
+			list_append(entries, entry);
+		}
+		closedir(user_dir);
+		xfree(user_path);
+	}
+	closedir(top_dir);
+
+	return total;
+}
+
+/*
+ * Remove least recently used blocks until the cache is back to 90 percent
+ * of its size limit. cache_mutex must be locked.
+ */
+static void _evict(void)
+{
+	List entries = list_create(_free_entry);
+	cache_entry_t *entry;
+	uint64_t target = (cache_limit / 10) * 9;
+	int removed = 0;
+
+	cache_used = _scan_cache(entries);
+	list_sort(entries, _sort_by_mtime);
+	while ((cache_used > target) && (entry = list_pop(entries))) {
+		if (!unlink(entry->path)) {
+			cache_used -= MIN(cache_used, entry->size);
+			removed++;
+		} else if (errno != ENOENT) {
+			error("%s: unlink(%s): %m", __func__, entry->path);
+		}
+		_free_entry(entry);
+	}
+	FREE_NULL_LIST(entries);
+
+	debug("%s: removed %d blocks, %"PRIu64" bytes cached",
+	      __func__, removed, cache_used);
+}
+
+extern void bcast_cache_config(void)
+{
+	char *params, *dir, *size;
+	long size_mb = DEFAULT_CACHE_SIZE;
+
+	params = slurm_get_sbcast_parameters();
+	dir = _get_param(params, "CacheDir=");
+	size = _get_param(params, "CacheSize=");
+	xfree(params);
+
+	if (size && ((size_mb = str_to_mbytes(size)) < 0)) {
+		error("Invalid SbcastParameters CacheSize=%s, using %d MB",
+		      size, DEFAULT_CACHE_SIZE);
+		size_mb = DEFAULT_CACHE_SIZE;
+	}
+	xfree(size);
+
+	slurm_mutex_lock(&cache_mutex);
+	xfree(cache_dir);
+	cache_limit = (uint64_t) size_mb * 1024 * 1024;
+	if (dir && (dir[0] != '/')) {
+		error("SbcastParameters CacheDir=%s is not an absolute path, sbcast cache disabled",
+		      dir);
+		xfree(dir);
+	} else if (dir && mkdir(dir, 0700) && (errno != EEXIST)) {
+		error("Unable to create sbcast cache directory %s: %m, sbcast cache disabled",
+		      dir);
+		xfree(dir);
+	}
+	cache_dir = dir;
+	if (cache_dir) {
+		cache_used = _scan_cache(NULL);
+		debug("sbcast cache %s holds %"PRIu64" of %"PRIu64" bytes",
+		      cache_dir, cache_used, cache_limit);
+		if (cache_used > cache_limit)
+			_evict();
+	}
+	slurm_mutex_unlock(&cache_mutex);
+}
+
+extern int bcast_cache_load(uid_t uid, char *hash, uint32_t len,
+			    char **data)
+{
+	char *path;
+	struct stat st;
+	int fd, rc = SLURM_ERROR;
+	uint32_t offset = 0;
+	ssize_t inx;
+
+	if (!_valid_hash(hash))
+		return SLURM_ERROR;
+
+	slurm_mutex_lock(&cache_mutex);
+	if (!cache_dir) {
+		slurm_mutex_unlock(&cache_mutex);
+		return SLURM_ERROR;
+	}
+	path = xstrdup_printf("%s/%u/%s", cache_dir, (uint32_t) uid, hash);
+	slurm_mutex_unlock(&cache_mutex);
+
+	if ((fd = open(path, O_RDONLY)) < 0) {
+		xfree(path);
+		return SLURM_ERROR;
+	}
+	if (fstat(fd, &st) || (st.st_size != len)) {
+		debug("%s: size mismatch for cached block %s", __func__, path);
+		goto fini;
+	}
+
+	*data = xmalloc(MAX(len, 1));
+	while (offset < len) {
+		inx = read(fd, *data + offset, len - offset);
+		if (inx < 0) {
+			if ((errno == EINTR) || (errno == EAGAIN))
+				continue;
+			error("%s: read(%s): %m", __func__, path);
+			break;
+		} else if (inx == 0) {
+			break;
+		}
+		offset += inx;
+	}
+	if (offset == len) {
+		rc = SLURM_SUCCESS;
+		/* The modification time orders blocks for eviction */
+		(void) futimens(fd, NULL);
+	} else {
+		xfree(*data);
+	}
+
+fini:
+	close(fd);
+	xfree(path);
+	return rc;
+}
+
+extern void bcast_cache_store(uid_t uid, char *hash, char *data,
+			      uint32_t len)
+{
+	char *user_dir = NULL, *path = NULL, *tmp_path = NULL;
+	uint32_t offset = 0;
+	ssize_t inx;
+	int fd;
+
+	if (!_valid_hash(hash))
+		return;
+
+	slurm_mutex_lock(&cache_mutex);
+	if (!cache_dir || (len > cache_limit)) {
+		slurm_mutex_unlock(&cache_mutex);
+		return;
+	}
+	user_dir = xstrdup_printf("%s/%u", cache_dir, (uint32_t) uid);
+	slurm_mutex_unlock(&cache_mutex);
+
+	path = xstrdup_printf("%s/%s", user_dir, hash);
+	if (!access(path, F_OK))
+		goto fini;	/* already cached by an earlier transfer */
+
+	if (mkdir(user_dir, 0700) && (errno != EEXIST)) {
+		error("%s: mkdir(%s): %m", __func__, user_dir);
+		goto fini;
+	}
+
+	/* Write to a temporary file so readers never see partial blocks */
+	tmp_path = xstrdup_printf("%s/.%s.XXXXXX", user_dir, hash);
+	if ((fd = mkstemp(tmp_path)) < 0) {
+		error("%s: mkstemp(%s): %m", __func__, tmp_path);
+		goto fini;
+	}
+	while (offset < len) {
+		inx = write(fd, data + offset, len - offset);
+		if (inx < 0) {
+			if ((errno == EINTR) || (errno == EAGAIN))
+				continue;
+			error("%s: write(%s): %m", __func__, tmp_path);
+			break;
+		}
+		offset += inx;
+	}
+	close(fd);
+	if ((offset != len) || rename(tmp_path, path)) {
+		if (offset == len)
+			error("%s: rename(%s): %m", __func__, path);
+		(void) unlink(tmp_path);
+		goto fini;
+	}
+
+	slurm_mutex_lock(&cache_mutex);
+	cache_used += len;
+	if (cache_dir && (cache_used > cache_limit))
+		_evict();
+	slurm_mutex_unlock(&cache_mutex);
+
+fini:
+	xfree(user_dir);
+	xfree(path);
+	xfree(tmp_path);
+}
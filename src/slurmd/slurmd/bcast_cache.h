@@ -0,0 +1,74 @@
+/*****************************************************************************\
+ *  bcast_cache.h - sbcast content addressed block cache
+ *****************************************************************************
+ *  Copyright (C) 2018 SchedMD LLC.
+ *
+ *  This file is part of Slurm, a resource management program.
+ *  For details, see <https://slurm.schedmd.com/>.
+ *  Please also read the included file: DISCLAIMER.
+ *
+ *  Slurm is free software; you can redistribute it and/or modify it under
+ *  the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  In addition, as a special exception, the copyright holders give permission
+ *  to link the code of portions of this program with the OpenSSL library under
+ *  certain conditions as described in each individual source file, and
+ *  distribute linked combinations including the two. You must obey the GNU
+ *  General Public License in all respects for all of the code used other than
+ *  OpenSSL. If you modify file(s) with this exception, you may extend this
+ *  exception to your version of the file(s), but you are not obligated to do
+ *  so. If you do not wish to do so, delete this exception statement from your
+ *  version.  If you delete this exception statement from all source files in
+ *  the program, then also delete it here.
+ *
+ *  Slurm is distributed in the hope that it will be useful, but WITHOUT ANY
+ *  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *  FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ *  details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with Slurm; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA.
+\*****************************************************************************/
+
+#ifndef _SLURMD_BCAST_CACHE_H
+#define _SLURMD_BCAST_CACHE_H
+
+#include <inttypes.h>
+#include <sys/types.h>
+
+/*
+ * Blocks broadcast by sbcast are cached in files named by the SHA-256 hash
+ * of their contents under SbcastParameters=CacheDir, in a subdirectory per
+ * user. A user's blocks are only ever served back to that same user.
+ * The cache is trimmed back to 90 percent of SbcastParameters=CacheSize,
+ * least recently used blocks first, whenever it grows beyond that size.
+ */
+
+/* Load cache configuration, call on slurmd startup and reconfiguration */
+extern void bcast_cache_config(void);
+
+/*
+ * Read a block from the cache
+ * IN uid - user who sent the block
+ * IN hash - hash of the block's data
+ * IN len - expected length of the block's data
+ * OUT data - block data, xfree() when done
+ * RET SLURM_SUCCESS or SLURM_ERROR if not cached
+ */
+extern int bcast_cache_load(uid_t uid, char *hash, uint32_t len,
+			    char **data);
+
+/*
+ * Add a block to the cache, if caching is enabled
+ * IN uid - user who sent the block
+ * IN hash - hash of the block's data
+ * IN data - block data
+ * IN len - length of the block's data
+ */
+extern void bcast_cache_store(uid_t uid, char *hash, char *data,
+			      uint32_t len);
+
+#endif
@@ -41,6 +41,8 @@
 
 #include "config.h"
 
+#define _GNU_SOURCE
+
 #include <ctype.h>
 #include <fcntl.h>
 #include <grp.h>
@@ -88,15 +90,19 @@
 #include "src/common/slurm_protocol_api.h"
 #include "src/common/slurm_protocol_interface.h"
 #include "src/common/stepd_api.h"
+#include "src/common/timers.h"
 #include "src/common/uid.h"
 #include "src/common/util-net.h"
 #include "src/common/xstring.h"
 #include "src/common/xmalloc.h"
 
 #include "src/bcast/file_bcast.h"
+#include "src/bcast/sha256.h"
 
+#include "src/slurmd/slurmd/bcast_cache.h"
 #include "src/slurmd/slurmd/get_mach_stat.h"
 #include "src/slurmd/slurmd/slurmd.h"
+#include "src/slurmd/slurmd/stepd_pool.h"
 
 #include "src/slurmd/common/fname.h"
 #include "src/slurmd/common/job_container_plugin.h"
@@ -668,20 +674,17 @@ rwfail:
 
 
 /*
- * Fork and exec the slurmstepd, then send the slurmstepd its
- * initialization data.  Then wait for slurmstepd to send an "ok"
- * message before returning.  When the "ok" message is received,
- * the slurmstepd has created and begun listening on its unix
- * domain socket.
+ * Fork and exec a slurmstepd which will wait for its initialization data
+ * on the to_stepd pipe and send its return code on the to_slurmd pipe.
+ * type and req are only used to name the log files of memory checkers.
  *
  * Note that this code forks twice and it is the grandchild that
  * becomes the slurmstepd process, so the slurmstepd's parent process
  * will be init, not slurmd.
  */
 static int
-_forkexec_slurmstepd(uint16_t type, void *req,
-		     slurm_addr_t *cli, slurm_addr_t *self,
-		     const hostset_t step_hset, uint16_t protocol_version)
+_spawn_slurmstepd(uint16_t type, void *req, int *to_stepd_fd,
+		  int *to_slurmd_fd)
 {
 	pid_t pid;
 	int to_stepd[2] = {-1, -1};
@@ -692,86 +695,29 @@ _forkexec_slurmstepd(uint16_t type, void *req,
 		return SLURM_FAILURE;
 	}
 
-	if (_add_starting_step(type, req)) {
-		error("_forkexec_slurmstepd failed in _add_starting_step: %m");
-		return SLURM_FAILURE;
-	}
-
 	if ((pid = fork()) < 0) {
 		error("_forkexec_slurmstepd: fork: %m");
 		close(to_stepd[0]);
 		close(to_stepd[1]);
 		close(to_slurmd[0]);
 		close(to_slurmd[1]);
-		_remove_starting_step(type, req);
 		return SLURM_FAILURE;
 	} else if (pid > 0) {
-		int rc = SLURM_SUCCESS;
-#if (SLURMSTEPD_MEMCHECK == 0)
-		int i;
-		time_t start_time = time(NULL);
-#endif
-		/*
-		 * Parent sends initialization data to the slurmstepd
-		 * over the to_stepd pipe, and waits for the return code
-		 * reply on the to_slurmd pipe.
-		 */
 		if (close(to_stepd[0]) < 0)
 			error("Unable to close read to_stepd in parent: %m");
 		if (close(to_slurmd[1]) < 0)
 			error("Unable to close write to_slurmd in parent: %m");
 
-		if ((rc = _send_slurmstepd_init(to_stepd[1], type,
-						req, cli, self,
-						step_hset,
-						protocol_version)) != 0) {
-			error("Unable to init slurmstepd");
-			goto done;
-		}
-
-		/* If running under valgrind/memcheck, this pipe doesn't work
-		 * correctly so just skip it. */
-#if (SLURMSTEPD_MEMCHECK == 0)
-		i = read(to_slurmd[0], &rc, sizeof(int));
-		if (i < 0) {
-			error("%s: Can not read return code from slurmstepd "
-			      "got %d: %m", __func__, i);
-			rc = SLURM_FAILURE;
-		} else if (i != sizeof(int)) {
-			error("%s: slurmstepd failed to send return code "
-			      "got %d: %m", __func__, i);
-			rc = SLURM_FAILURE;
-		} else {
-			int delta_time = time(NULL) - start_time;
-			int cc;
-			if (delta_time > 5) {
-				info("Warning: slurmstepd startup took %d sec, "
-				     "possible file system problem or full "
-				     "memory", delta_time);
-			}
-			if (rc != SLURM_SUCCESS)
-				error("slurmstepd return code %d", rc);
-
-			cc = SLURM_SUCCESS;
-			cc = write(to_stepd[1], &cc, sizeof(int));
-			if (cc != sizeof(int)) {
-				error("%s: failed to send ack to stepd %d: %m",
-				      __func__, cc);
-			}
-		}
-#endif
-	done:
-		if (_remove_starting_step(type, req))
-			error("Error cleaning up starting_step list");
-
 		/* Reap child */
 		if (waitpid(pid, NULL, 0) < 0)
 			error("Unable to reap slurmd child process");
-		if (close(to_stepd[1]) < 0)
-			error("close write to_stepd in parent: %m");
-		if (close(to_slurmd[0]) < 0)
-			error("close read to_slurmd in parent: %m");
-		return rc;
+
+		/* Keep pooled pipes out of other children of slurmd */
+		fd_set_close_on_exec(to_stepd[1]);
+		fd_set_close_on_exec(to_slurmd[0]);
+		*to_stepd_fd = to_stepd[1];
+		*to_slurmd_fd = to_slurmd[0];
+		return SLURM_SUCCESS;
 	} else {
 #if (SLURMSTEPD_MEMCHECK == 1)
 		/* memcheck test of slurmstepd, option #1 */
@@ -922,6 +868,122 @@ _forkexec_slurmstepd(uint16_t type, void *req,
 	}
 }
 
+/* Spawn a slurmstepd for the pool of pre-forked slurmstepds */
+extern int stepd_pool_spawn(int *to_stepd_fd, int *to_slurmd_fd)
+{
+	return _spawn_slurmstepd(0, NULL, to_stepd_fd, to_slurmd_fd);
+}
+
+/*
+ * Fork and exec the slurmstepd, or take a pre-forked one from the pool,
+ * then send the slurmstepd its initialization data.  Then wait for
+ * slurmstepd to send an "ok" message before returning.  When the "ok"
+ * message is received, the slurmstepd has created and begun listening
+ * on its unix domain socket.
+ */
+static int
+_forkexec_slurmstepd(uint16_t type, void *req,
+		     slurm_addr_t *cli, slurm_addr_t *self,
+		     const hostset_t step_hset, uint16_t protocol_version)
+{
+	int to_stepd = -1, to_slurmd = -1;
+	int rc = SLURM_SUCCESS;
+	bool pooled, use_pool = true;
+#if (SLURMSTEPD_MEMCHECK == 0)
+	int i;
+	time_t start_time = time(NULL);
+#endif
+	DEF_TIMERS;
+
+	START_TIMER;
+	if (_add_starting_step(type, req)) {
+		error("_forkexec_slurmstepd failed in _add_starting_step: %m");
+		return SLURM_FAILURE;
+	}
+
+spawn:
+	pooled = use_pool && stepd_pool_take(&to_stepd, &to_slurmd);
+	if (!pooled && _spawn_slurmstepd(type, req, &to_stepd, &to_slurmd)) {
+		_remove_starting_step(type, req);
+		return SLURM_FAILURE;
+	}
+
+	/*
+	 * Send initialization data to the slurmstepd over the to_stepd
+	 * pipe, and wait for the return code reply on the to_slurmd pipe.
+	 */
+	if ((rc = _send_slurmstepd_init(to_stepd, type,
+					req, cli, self,
+					step_hset,
+					protocol_version)) != 0) {
+		if (pooled)
+			goto pool_fail;
+		error("Unable to init slurmstepd");
+		goto done;
+	}
+
+	/* If running under valgrind/memcheck, this pipe doesn't work
+	 * correctly so just skip it. */
+#if (SLURMSTEPD_MEMCHECK == 0)
+	i = read(to_slurmd, &rc, sizeof(int));
+	if (pooled && (i != sizeof(int)))
+		goto pool_fail;
+	if (i < 0) {
+		error("%s: Can not read return code from slurmstepd "
+		      "got %d: %m", __func__, i);
+		rc = SLURM_FAILURE;
+	} else if (i != sizeof(int)) {
+		error("%s: slurmstepd failed to send return code "
+		      "got %d: %m", __func__, i);
+		rc = SLURM_FAILURE;
+	} else {
+		int delta_time = time(NULL) - start_time;
+		int cc;
+		if (delta_time > 5) {
+			info("Warning: slurmstepd startup took %d sec, "
+			     "possible file system problem or full "
+			     "memory", delta_time);
+		}
+		if (rc != SLURM_SUCCESS)
+			error("slurmstepd return code %d", rc);
+
+		cc = SLURM_SUCCESS;
+		cc = write(to_stepd, &cc, sizeof(int));
+		if (cc != sizeof(int)) {
+			error("%s: failed to send ack to stepd %d: %m",
+			      __func__, cc);
+		}
+	}
+#endif
+	END_TIMER;
+	debug2("%s: %s slurmstepd started in %s", __func__,
+	       pooled ? "pre-forked" : "new", TIME_STR);
+	stepd_pool_launch_add(DELTA_TIMER, pooled);
+done:
+	if (_remove_starting_step(type, req))
+		error("Error cleaning up starting_step list");
+
+	if (close(to_stepd) < 0)
+		error("close write to_stepd in parent: %m");
+	if (close(to_slurmd) < 0)
+		error("close read to_slurmd in parent: %m");
+	return rc;
+
+pool_fail:
+	/*
+	 * The pre-forked slurmstepd died while idle (e.g. OOM killed).
+	 * Closing its pipes makes it exit if it is somehow still alive,
+	 * init reaps it as its parent. Retry once with a new slurmstepd.
+	 */
+	info("%s: pre-forked slurmstepd is gone, spawning a new one",
+	     __func__);
+	(void) close(to_stepd);
+	(void) close(to_slurmd);
+	use_pool = false;
+	rc = SLURM_SUCCESS;
+	goto spawn;
+}
+
 static void _setup_x11_display(uint32_t job_id, uint32_t step_id,
 			       char ***env, uint32_t *envc)
 {
@@ -4120,6 +4182,7 @@ void file_bcast_init(void)
 {
 	/* skip locks during slurmd init */
 	file_bcast_list = list_create(_free_file_bcast_info_t);
+	bcast_cache_config();
 }
 
 void file_bcast_purge(void)
@@ -4149,6 +4212,21 @@ static int _rpc_file_bcast(slurm_msg_t *msg)
 
 	key.job_id = cred_arg->job_id;
 
+	if (req->cache_probe) {
+		/*
+		 * Only the block's hash was sent. Supply the data from our
+		 * cache or have sbcast send the block itself.
+		 */
+		xfree(req->block);
+		if (bcast_cache_load(key.uid, req->block_hash, req->uncomp_len,
+				     &req->block) != SLURM_SUCCESS) {
+			sbcast_cred_arg_free(cred_arg);
+			return ESLURMD_BCAST_CACHE_MISS;
+		}
+		req->block_len = req->uncomp_len;
+		req->compress = COMPRESS_OFF;
+	}
+
 #if 0
 	info("last_block=%u force=%u modes=%o",
 	     req->last_block, req->force, req->modes);
@@ -4195,10 +4273,15 @@ static int _rpc_file_bcast(slurm_msg_t *msg)
 		return SLURM_FAILURE;
 	}
 
+	/*
+	 * Write at the block's own offset rather than the current file
+	 * position, sbcast may have several blocks of a file in transit.
+	 */
 	offset = 0;
 	while (req->block_len - offset) {
-		inx = write(file_info->fd, &req->block[offset],
-			    (req->block_len - offset));
+		inx = pwrite(file_info->fd, &req->block[offset],
+			     (req->block_len - offset),
+			     req->block_offset + offset);
 		if (inx == -1) {
 			if ((errno == EINTR) || (errno == EAGAIN))
 				continue;
@@ -4210,6 +4293,20 @@ static int _rpc_file_bcast(slurm_msg_t *msg)
 		offset += inx;
 	}
 
+	if (req->block_hash && !req->cache_probe) {
+		char hash[SHA256_HEX_LEN];
+
+		/* Only cache what was received under its real hash */
+		sha256_hex(req->block, req->block_len, hash);
+		if (xstrcmp(hash, req->block_hash)) {
+			error("sbcast: uid:%u block %u of `%s` does not match its hash, not caching it",
+			      key.uid, req->block_no, key.fname);
+		} else {
+			bcast_cache_store(key.uid, req->block_hash,
+					  req->block, req->block_len);
+		}
+	}
+
 	file_info->last_update = time(NULL);
 
 	if (req->last_block && fchmod(file_info->fd, (req->modes & 0777))) {
@@ -4312,6 +4409,24 @@ static int _file_bcast_register_file(slurm_msg_t *msg,
 		return SLURM_ERROR;
 	}
 
+#ifdef FALLOC_FL_KEEP_SIZE
+	/*
+	 * Reserve the file's space up front so blocks written out of order
+	 * do not fragment it and a full file system is reported right away.
+	 */
+	if (req->file_size &&
+	    fallocate(fd, FALLOC_FL_KEEP_SIZE, 0, req->file_size)) {
+		if (errno == ENOSPC) {
+			error("sbcast: uid:%u can't allocate %"PRIu64" bytes for `%s`: %m",
+			      key->uid, req->file_size, req->fname);
+			close(fd);
+			return SLURM_ERROR;
+		}
+		debug("sbcast: uid:%u can't preallocate `%s`: %m",
+		      key->uid, req->fname);
+	}
+#endif
+
 	file_info = xmalloc(sizeof(file_bcast_info_t));
 	file_info->fd = fd;
 	file_info->fname = xstrdup(req->fname);
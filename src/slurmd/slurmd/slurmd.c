@@ -106,7 +106,9 @@
 #include "src/slurmd/slurmd/get_mach_stat.h"
 #include "src/slurmd/common/job_container_plugin.h"
 #include "src/slurmd/common/proctrack.h"
+#include "src/slurmd/slurmd/bcast_cache.h"
 #include "src/slurmd/slurmd/req.h"
+#include "src/slurmd/slurmd/stepd_pool.h"
 #include "src/slurmd/common/run_script.h"
 #include "src/slurmd/common/set_oomadj.h"
 #include "src/slurmd/common/setproctitle.h"
@@ -364,6 +366,7 @@ main (int argc, char **argv)
 	list_install_fork_handlers();
 	slurm_conf_install_fork_handlers();
 	record_launched_jobs();
+	stepd_pool_config();
 
 	run_script_health_check();
 
@@ -385,6 +388,7 @@ main (int argc, char **argv)
 		error("Unable to remove pidfile `%s': %m", conf->pidfile);
 
 	_wait_for_all_threads(120);
+	stepd_pool_purge();
 	_slurmd_fini();
 	_destroy_conf();
 	slurm_crypto_fini();	/* must be after _destroy_conf() */
@@ -1074,6 +1078,8 @@ _reconfigure(void)
 	_set_topo_info();
 	route_g_reconfigure();
 	cpu_freq_reconfig();
+	bcast_cache_config();
+	stepd_pool_config();
 
 	msg_aggr_sender_reconfig(conf->msg_aggr_window_time,
 				 conf->msg_aggr_window_msgs);
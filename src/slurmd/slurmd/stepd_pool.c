@@ -0,0 +1,244 @@
+/*****************************************************************************\
+ *  stepd_pool.c - pool of pre-forked slurmstepds
+ *****************************************************************************
+ *  Copyright (C) 2018 SchedMD LLC.
+ *
+ *  This file is part of Slurm, a resource management program.
+ *  For details, see <https://slurm.schedmd.com/>.
+ *  Please also read the included file: DISCLAIMER.
+ *
+ *  Slurm is free software; you can redistribute it and/or modify it under
+ *  the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  In addition, as a special exception, the copyright holders give permission
+ *  to link the code of portions of this program with the OpenSSL library under
+ *  certain conditions as described in each individual source file, and
+ *  distribute linked combinations including the two. You must obey the GNU
+ *  General Public License in all respects for all of the code used other than
+ *  OpenSSL. If you modify file(s) with this exception, you may extend this
+ *  exception to your version of the file(s), but you are not obligated to do
+ *  so. If you do not wish to do so, delete this exception statement from your
+ *  version.  If you delete this exception statement from all source files in
+ *  the program, then also delete it here.
+ *
+ *  Slurm is distributed in the hope that it will be useful, but WITHOUT ANY
+ *  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *  FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ *  details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with Slurm; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA.
+\*****************************************************************************/
+
+#include "config.h"
+
+#define _GNU_SOURCE
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "src/common/log.h"
+#include "src/common/macros.h"
+#include "src/common/slurm_protocol_api.h"
+#include "src/common/xmalloc.h"
+#include "src/common/xstring.h"
+
+#include "src/slurmd/common/slurmstepd_init.h"
+#include "src/slurmd/slurmd/stepd_pool.h"
+
+#define STEPD_POOL_MAX 64
+
+/* slurmstepd launch latency, bucket i counts launches < 2^i msec */
+#define LAUNCH_HIST_BUCKETS 12
+
+/* pipes to a pre-forked slurmstepd waiting for its initialization data */
+typedef struct {
+	int to_stepd;
+	int to_slurmd;
+} stepd_pool_ent_t;
+
+static pthread_mutex_t stepd_pool_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t  stepd_pool_cond  = PTHREAD_COND_INITIALIZER;
+static stepd_pool_ent_t *stepd_pool = NULL;
+static int stepd_pool_cnt = 0, stepd_pool_size = 0;
+static bool stepd_pool_refilling = false;
+
+static uint32_t launch_hist[LAUNCH_HIST_BUCKETS];
+static uint32_t launch_hist_cnt = 0, launch_hist_pooled = 0;
+
+/*
+ * Spawn slurmstepds until the pool holds stepd_pool_size of them. Runs in
+ * its own thread so that launch RPCs never wait for a refill.
+ */
+static void *_stepd_pool_refill(void *arg)
+{
+	stepd_pool_ent_t ent;
+
+	slurm_mutex_lock(&stepd_pool_mutex);
+	while (stepd_pool_cnt < stepd_pool_size) {
+		slurm_mutex_unlock(&stepd_pool_mutex);
+		if (stepd_pool_spawn(&ent.to_stepd, &ent.to_slurmd)) {
+			slurm_mutex_lock(&stepd_pool_mutex);
+			break;
+		}
+		slurm_mutex_lock(&stepd_pool_mutex);
+		if (stepd_pool_cnt >= stepd_pool_size) {
+			/* pool shrunk or was purged meanwhile */
+			close(ent.to_stepd);
+			close(ent.to_slurmd);
+			break;
+		}
+		stepd_pool[stepd_pool_cnt++] = ent;
+	}
+	stepd_pool_refilling = false;
+	slurm_cond_broadcast(&stepd_pool_cond);
+	slurm_mutex_unlock(&stepd_pool_mutex);
+
+	return NULL;
+}
+
+/* stepd_pool_mutex must be locked */
+static void _stepd_pool_refill_start(void)
+{
+	if (stepd_pool_refilling || (stepd_pool_cnt >= stepd_pool_size))
+		return;
+	stepd_pool_refilling = true;
+	slurm_thread_create_detached(NULL, _stepd_pool_refill, NULL);
+}
+
+/* stepd_pool_mutex must be locked */
+static void _stepd_pool_drain(void)
+{
+	while (stepd_pool_refilling)
+		slurm_cond_wait(&stepd_pool_cond, &stepd_pool_mutex);
+	/* closing the pipes makes the idle slurmstepds exit */
+	while (stepd_pool_cnt > 0) {
+		stepd_pool_cnt--;
+		close(stepd_pool[stepd_pool_cnt].to_stepd);
+		close(stepd_pool[stepd_pool_cnt].to_slurmd);
+	}
+}
+
+extern bool stepd_pool_take(int *to_stepd_fd, int *to_slurmd_fd)
+{
+	bool rc = false;
+
+	slurm_mutex_lock(&stepd_pool_mutex);
+	if (stepd_pool_cnt > 0) {
+		stepd_pool_cnt--;
+		*to_stepd_fd = stepd_pool[stepd_pool_cnt].to_stepd;
+		*to_slurmd_fd = stepd_pool[stepd_pool_cnt].to_slurmd;
+		rc = true;
+	}
+	_stepd_pool_refill_start();
+	slurm_mutex_unlock(&stepd_pool_mutex);
+
+	return rc;
+}
+
+extern void stepd_pool_launch_add(long usec, bool pooled)
+{
+	long msec = usec / 1000;
+	int i = 0;
+
+	while (msec && (i < (LAUNCH_HIST_BUCKETS - 1))) {
+		msec >>= 1;
+		i++;
+	}
+	slurm_mutex_lock(&stepd_pool_mutex);
+	launch_hist[i]++;
+	launch_hist_cnt++;
+	if (pooled)
+		launch_hist_pooled++;
+	slurm_mutex_unlock(&stepd_pool_mutex);
+}
+
+static void _launch_hist_log(void)
+{
+	char *str = NULL, *sep = "";
+	int i;
+
+	slurm_mutex_lock(&stepd_pool_mutex);
+	if (!launch_hist_cnt) {
+		slurm_mutex_unlock(&stepd_pool_mutex);
+		return;
+	}
+	for (i = 0; i < LAUNCH_HIST_BUCKETS; i++) {
+		if (!launch_hist[i])
+			continue;
+		if (i == (LAUNCH_HIST_BUCKETS - 1)) {
+			xstrfmtcat(str, "%s>=%dms:%u", sep, 1 << (i - 1),
+				   launch_hist[i]);
+		} else {
+			xstrfmtcat(str, "%s<%dms:%u", sep, 1 << i,
+				   launch_hist[i]);
+		}
+		sep = " ";
+	}
+	info("slurmstepd launches: %u (%u pre-forked), latency %s",
+	     launch_hist_cnt, launch_hist_pooled, str);
+	slurm_mutex_unlock(&stepd_pool_mutex);
+	xfree(str);
+}
+
+extern void stepd_pool_config(void)
+{
+	char *launch_params, *tmp;
+	int size = 0;
+
+	launch_params = slurm_get_launch_params();
+	if (launch_params &&
+	    (tmp = strcasestr(launch_params, "slurmstepd_prefork="))) {
+		size = atoi(tmp + 19);
+		if ((size < 0) || (size > STEPD_POOL_MAX)) {
+			error("Invalid LaunchParameters slurmstepd_prefork=%d, using %d",
+			      size, STEPD_POOL_MAX);
+			size = STEPD_POOL_MAX;
+		}
+	}
+	xfree(launch_params);
+#if (SLURMSTEPD_MEMCHECK != 0)
+	size = 0;
+#endif
+
+	_launch_hist_log();
+
+	slurm_mutex_lock(&stepd_pool_mutex);
+	stepd_pool_size = 0;
+	_stepd_pool_drain();
+	if (size) {
+		xrealloc(stepd_pool, sizeof(stepd_pool_ent_t) * size);
+		debug("keeping %d pre-forked slurmstepds", size);
+	} else
+		xfree(stepd_pool);
+	stepd_pool_size = size;
+	_stepd_pool_refill_start();
+	slurm_mutex_unlock(&stepd_pool_mutex);
+}
+
+extern int stepd_pool_idle(void)
+{
+	int cnt;
+
+	slurm_mutex_lock(&stepd_pool_mutex);
+	cnt = stepd_pool_cnt;
+	slurm_mutex_unlock(&stepd_pool_mutex);
+
+	return cnt;
+}
+
+extern void stepd_pool_purge(void)
+{
+	_launch_hist_log();
+
+	slurm_mutex_lock(&stepd_pool_mutex);
+	stepd_pool_size = 0;
+	_stepd_pool_drain();
+	xfree(stepd_pool);
+	slurm_mutex_unlock(&stepd_pool_mutex);
+}
@@ -0,0 +1,79 @@
+/*****************************************************************************\
+ *  stepd_pool.h - pool of pre-forked slurmstepds
+ *****************************************************************************
+ *  Copyright (C) 2018 SchedMD LLC.
+ *
+ *  This file is part of Slurm, a resource management program.
+ *  For details, see <https://slurm.schedmd.com/>.
+ *  Please also read the included file: DISCLAIMER.
+ *
+ *  Slurm is free software; you can redistribute it and/or modify it under
+ *  the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  In addition, as a special exception, the copyright holders give permission
+ *  to link the code of portions of this program with the OpenSSL library under
+ *  certain conditions as described in each individual source file, and
+ *  distribute linked combinations including the two. You must obey the GNU
+ *  General Public License in all respects for all of the code used other than
+ *  OpenSSL. If you modify file(s) with this exception, you may extend this
+ *  exception to your version of the file(s), but you are not obligated to do
+ *  so. If you do not wish to do so, delete this exception statement from your
+ *  version.  If you delete this exception statement from all source files in
+ *  the program, then also delete it here.
+ *
+ *  Slurm is distributed in the hope that it will be useful, but WITHOUT ANY
+ *  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *  FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ *  details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with Slurm; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA.
+\*****************************************************************************/
+
+#ifndef _SLURMD_STEPD_POOL_H
+#define _SLURMD_STEPD_POOL_H
+
+#include <stdbool.h>
+
+/*
+ * slurmd keeps LaunchParameters=slurmstepd_prefork=# slurmstepds forked
+ * ahead of time, each waiting on its pipe for the initialization data of
+ * the job step it is to run. A background thread refills the pool after
+ * every slurmstepd taken from it.
+ */
+
+/*
+ * Fork a slurmstepd for the pool, defined by the caller (req.c)
+ * OUT to_stepd_fd - pipe to write the slurmstepd's initialization data to
+ * OUT to_slurmd_fd - pipe to read the slurmstepd's replies from
+ * RET SLURM_SUCCESS or SLURM_ERROR
+ */
+extern int stepd_pool_spawn(int *to_stepd_fd, int *to_slurmd_fd);
+
+/*
+ * Read LaunchParameters=slurmstepd_prefork=# and (re)build the pool.
+ * Idle slurmstepds are replaced on every call as they may carry an outdated
+ * configuration. Call on slurmd startup and reconfiguration.
+ */
+extern void stepd_pool_config(void);
+
+/* Close all idle slurmstepds and free the pool, call on slurmd shutdown */
+extern void stepd_pool_purge(void);
+
+/*
+ * Take an idle slurmstepd from the pool and start refilling it
+ * OUT to_stepd_fd, to_slurmd_fd - pipes of the slurmstepd, see above
+ * RET false if the pool is empty
+ */
+extern bool stepd_pool_take(int *to_stepd_fd, int *to_slurmd_fd);
+
+/* Return the count of idle slurmstepds currently in the pool */
+extern int stepd_pool_idle(void);
+
+/* Record the latency of one slurmstepd launch in the launch histogram */
+extern void stepd_pool_launch_add(long usec, bool pooled);
+
+#endif
@@ -40,6 +40,7 @@
 
 #include "config.h"
 
+#include <poll.h>
 #include <signal.h>
 #include <stdlib.h>
 #include <sys/mman.h>
@@ -455,6 +456,18 @@ static void _set_job_log_prefix(uint32_t jobid, uint32_t stepid)
 	log_set_fpfx(&buf);
 }
 
+/* Return true once data from slurmd is available on sock */
+static bool _wait_for_slurmd(int sock)
+{
+	struct pollfd pfd = { .fd = sock, .events = POLLIN };
+
+	while (poll(&pfd, 1, -1) < 0) {
+		if ((errno != EINTR) && (errno != EAGAIN))
+			return false;
+	}
+	return (pfd.revents & POLLIN);
+}
+
 /*
  *  This function handles the initialization information from slurmd
  *  sent by _send_slurmstepd_init() in src/slurmd/slurmd/req.c.
@@ -479,6 +492,13 @@ _init_from_slurmd(int sock, char **argv,
 
 	log_init(argv[0], lopts, LOG_DAEMON, NULL);
 
+	/*
+	 * A pre-forked slurmstepd waits here until slurmd hands it a step.
+	 * slurmd closes the pipe instead when it drains its pool.
+	 */
+	if (!_wait_for_slurmd(sock))
+		exit(0);
+
 	/* receive conf from slurmd */
 	if (!(conf = read_slurmd_conf_lite(sock)))
 		fatal("Failed to read conf from slurmd");
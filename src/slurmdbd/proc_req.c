@@ -61,6 +61,7 @@
 #include "src/slurmdbd/rpc_mgr.h"
 #include "src/slurmdbd/proc_req.h"
 #include "src/slurmdbd/slurmdbd.h"
+#include "src/slurmdbd/user_lane.h"
 #include "src/slurmctld/slurmctld.h"
 
 /* Local functions */
@@ -264,9 +265,20 @@ proc_req(void *conn, persist_msg_t *msg,
 	slurmdbd_conn_t *slurmdbd_conn = conn;
 	int rc = SLURM_SUCCESS;
 	char *comment = NULL;
-	int i, rpc_type_index = -1, rpc_user_index = -1;
+	int i, rpc_type_index = -1, rpc_user_index = -1, lane;
+	bool user_lane;
+	uint64_t lane_wait = 0;
 
 	DEF_TIMERS;
+
+	user_lane = user_lane_limited(msg->msg_type,
+				      slurmdbd_conn->conn->rem_port,
+				      slurmdbd_conn->in_mult_msg,
+				      _validate_slurm_user(*uid));
+	if (user_lane)
+		lane_wait = user_lane_enter(slurmdbd_conf->max_user_rpcs,
+					    slurmdbd_conn->conn->shutdown);
+
 	START_TIMER;
 
 	switch (msg->msg_type) {
@@ -562,6 +574,7 @@ proc_req(void *conn, persist_msg_t *msg,
 		      slurmdbd_conn->conn->fd,
 		      slurmdbd_msg_type_2_str(msg->msg_type, 1));
 	else if (slurmdbd_conn->conn->rem_port
+		 && !slurmdbd_conn->in_mult_msg
 		 && !slurmdbd_conf->commit_delay) {
 		/* If we are dealing with the slurmctld do the
 		   commit (SUCCESS or NOT) afterwards since we
@@ -573,7 +586,24 @@ proc_req(void *conn, persist_msg_t *msg,
 
 	END_TIMER;
 
+	if (user_lane)
+		user_lane_exit();
+
+	/* Registration may have just identified this as slurmctld */
+	if (slurmdbd_conn->conn->rem_port)
+		lane = SLURMDB_LANE_CTLD;
+	else
+		lane = SLURMDB_LANE_USER;
+
 	slurm_mutex_lock(&rpc_mutex);
+	if (rpc_stats.lane_cnt) {
+		rpc_stats.lane_cnt[lane]++;
+		rpc_stats.lane_time[lane] += DELTA_TIMER;
+		rpc_stats.lane_max_time[lane] =
+			MAX(rpc_stats.lane_max_time[lane], DELTA_TIMER);
+		rpc_stats.lane_wait_time[lane] += lane_wait;
+	}
+
 	for (i = 0; i < rpc_stats.type_cnt; i++) {
 		if (rpc_stats.rpc_type_id[i] == 0)
 			rpc_stats.rpc_type_id[i] = msg->msg_type;
@@ -3363,6 +3393,11 @@ static int   _send_mult_msg(slurmdbd_conn_t *slurmdbd_conn,
 	}
 
 	list_msg.my_list = list_create(slurmdbd_free_buffer);
+	/*
+	 * Apply the whole batch as one transaction, the commit is done when
+	 * this message is finished instead of after every record.
+	 */
+	slurmdbd_conn->in_mult_msg = true;
 	/* START_TIMER; */
 	itr = list_iterator_create(get_msg->my_list);
 	while ((req_buf = list_next(itr))) {
@@ -3386,6 +3421,7 @@ static int   _send_mult_msg(slurmdbd_conn_t *slurmdbd_conn,
 			break;
 	}
 	list_iterator_destroy(itr);
+	slurmdbd_conn->in_mult_msg = false;
 	/* END_TIMER; */
 	/* info("%d multi took %s", list_count(get_msg->my_list), TIME_STR); */
 
@@ -3600,6 +3636,12 @@ static int  _clear_stats(slurmdbd_conn_t *slurmdbd_conn,
 		rpc_stats.rpc_user_cnt[i] = 0;
 		rpc_stats.rpc_user_time[i] = 0;
 	}
+	for (i = 0; i < SLURMDB_LANE_COUNT; i++) {
+		rpc_stats.lane_cnt[i] = 0;
+		rpc_stats.lane_time[i] = 0;
+		rpc_stats.lane_max_time[i] = 0;
+		rpc_stats.lane_wait_time[i] = 0;
+	}
 	slurm_mutex_unlock(&rpc_mutex);
 
 	*out_buffer = slurm_persist_make_rc_msg(slurmdbd_conn->conn,
@@ -46,6 +46,7 @@
 typedef struct {
 	slurm_persist_conn_t *conn;
 	void *db_conn; /* database connection */
+	bool in_mult_msg; /* processing a DBD_SEND_MULT_MSG, commit at end */
 	char *tres_str;
 } slurmdbd_conn_t;
 
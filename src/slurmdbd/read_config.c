@@ -99,6 +99,7 @@ static void _clear_slurmdbd_conf(void)
 		slurmdbd_conf->debug_level = LOG_LEVEL_QUIET;
 		xfree(slurmdbd_conf->default_qos);
 		xfree(slurmdbd_conf->log_file);
+		slurmdbd_conf->max_user_rpcs = 0;
 		slurmdbd_conf->syslog_debug = LOG_LEVEL_QUIET;
 		xfree(slurmdbd_conf->pid_file);
 		xfree(slurmdbd_conf->plugindir);
@@ -157,6 +158,7 @@ extern int read_slurmdbd_conf(void)
 		{"LogFile", S_P_STRING},
 		{"LogTimeFormat", S_P_STRING},
 		{"MaxQueryTimeRange", S_P_STRING},
+		{"MaxUserRPCs", S_P_UINT16},
 		{"MessageTimeout", S_P_UINT16},
 		{"PidFile", S_P_STRING},
 		{"PluginDir", S_P_STRING},
@@ -302,6 +304,11 @@ extern int read_slurmdbd_conf(void)
 			slurmdbd_conf->max_time_range = INFINITE;
 		}
 
+		if (!s_p_get_uint16(&slurmdbd_conf->max_user_rpcs,
+				    "MaxUserRPCs", tbl))
+			slurmdbd_conf->max_user_rpcs =
+				DEFAULT_SLURMDBD_MAX_USER_RPCS;
+
 		if (!s_p_get_uint16(&slurmdbd_conf->msg_timeout,
 				    "MessageTimeout", tbl))
 			slurmdbd_conf->msg_timeout = DEFAULT_MSG_TIMEOUT;
@@ -643,6 +650,7 @@ extern void log_config(void)
 	debug2("DefaultQOS        = %s", slurmdbd_conf->default_qos);
 
 	debug2("LogFile           = %s", slurmdbd_conf->log_file);
+	debug2("MaxUserRPCs       = %u", slurmdbd_conf->max_user_rpcs);
 	debug2("MessageTimeout    = %u", slurmdbd_conf->msg_timeout);
 	debug2("PidFile           = %s", slurmdbd_conf->pid_file);
 	debug2("PluginDir         = %s", slurmdbd_conf->plugindir);
@@ -858,6 +866,11 @@ extern List dump_config(void)
 	key_pair->value = xstrdup_printf("%s", time_str);
 	list_append(my_list, key_pair);
 
+	key_pair = xmalloc(sizeof(config_key_pair_t));
+	key_pair->name = xstrdup("MaxUserRPCs");
+	key_pair->value = xstrdup_printf("%u", slurmdbd_conf->max_user_rpcs);
+	list_append(my_list, key_pair);
+
 	key_pair = xmalloc(sizeof(config_key_pair_t));
 	key_pair->name = xstrdup("MessageTimeout");
 	key_pair->value = xstrdup_printf("%u secs", slurmdbd_conf->msg_timeout);
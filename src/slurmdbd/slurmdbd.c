@@ -364,6 +364,15 @@ static void _init_dbd_stats(void)
 		xmalloc(sizeof(uint32_t) * rpc_stats.user_cnt);
 	rpc_stats.rpc_user_time =
 		xmalloc(sizeof(uint64_t) * rpc_stats.user_cnt);
+
+	rpc_stats.lane_cnt       =
+		xmalloc(sizeof(uint32_t) * SLURMDB_LANE_COUNT);
+	rpc_stats.lane_time      =
+		xmalloc(sizeof(uint64_t) * SLURMDB_LANE_COUNT);
+	rpc_stats.lane_max_time  =
+		xmalloc(sizeof(uint64_t) * SLURMDB_LANE_COUNT);
+	rpc_stats.lane_wait_time =
+		xmalloc(sizeof(uint64_t) * SLURMDB_LANE_COUNT);
 	slurm_mutex_unlock(&rpc_mutex);
 }
 
@@ -384,6 +393,11 @@ static void _free_dbd_stats(void)
 	xfree(rpc_stats.rpc_user_id);
 	xfree(rpc_stats.rpc_user_cnt);
 	xfree(rpc_stats.rpc_user_time);
+
+	xfree(rpc_stats.lane_cnt);
+	xfree(rpc_stats.lane_time);
+	xfree(rpc_stats.lane_max_time);
+	xfree(rpc_stats.lane_wait_time);
 	slurm_mutex_unlock(&rpc_mutex);
 }
 
@@ -0,0 +1,115 @@
+/*****************************************************************************\
+ *  user_lane.c - limit on concurrent RPCs from users other than slurmctld
+ *****************************************************************************
+ *  Copyright (C) 2018 SchedMD LLC.
+ *
+ *  This file is part of Slurm, a resource management program.
+ *  For details, see <https://slurm.schedmd.com/>.
+ *  Please also read the included file: DISCLAIMER.
+ *
+ *  Slurm is free software; you can redistribute it and/or modify it under
+ *  the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  In addition, as a special exception, the copyright holders give permission
+ *  to link the code of portions of this program with the OpenSSL library under
+ *  certain conditions as described in each individual source file, and
+ *  distribute linked combinations including the two. You must obey the GNU
+ *  General Public License in all respects for all of the code used other than
+ *  OpenSSL. If you modify file(s) with this exception, you may extend this
+ *  exception to your version of the file(s), but you are not obligated to do
+ *  so. If you do not wish to do so, delete this exception statement from your
+ *  version.  If you delete this exception statement from all source files in
+ *  the program, then also delete it here.
+ *
+ *  Slurm is distributed in the hope that it will be useful, but WITHOUT ANY
+ *  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *  FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ *  details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with Slurm; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA.
+\*****************************************************************************/
+
+#include "config.h"
+
+#include <pthread.h>
+
+#include "src/common/macros.h"
+#include "src/common/slurmdbd_defs.h"
+#include "src/common/timers.h"
+
+#include "src/slurmdbd/user_lane.h"
+
+static pthread_mutex_t user_lane_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t  user_lane_cond = PTHREAD_COND_INITIALIZER;
+static uint16_t        user_lane_cnt = 0;
+
+extern bool user_lane_limited(uint16_t msg_type, bool ctld_conn,
+			      bool in_mult_msg, bool slurm_user)
+{
+	/*
+	 * The records of a DBD_SEND_MULT_MSG are processed while the
+	 * DBD_SEND_MULT_MSG itself holds its slot, entering the lane again
+	 * for each of them would deadlock with MaxUserRPCs=1.
+	 */
+	if (ctld_conn || in_mult_msg || slurm_user)
+		return false;
+
+	switch (msg_type) {
+	case REQUEST_PERSIST_INIT:
+	case DBD_FINI:
+	case DBD_REGISTER_CTLD:
+	case DBD_GET_STATS:
+	case DBD_CLEAR_STATS:
+	case DBD_SHUTDOWN:
+	/* slurmctld sends these before it registers */
+	case DBD_JOB_START:
+	case DBD_SEND_MULT_JOB_START:
+	case DBD_SEND_MULT_MSG:
+		return false;
+	default:
+		return true;
+	}
+}
+
+extern uint64_t user_lane_enter(uint16_t max_rpcs, time_t *shutdown)
+{
+	struct timespec ts = {0, 0};
+	DEF_TIMERS;
+
+	START_TIMER;
+	slurm_mutex_lock(&user_lane_mutex);
+	while (max_rpcs && (user_lane_cnt >= max_rpcs) && !*shutdown) {
+		/* Wake periodically to notice shutdown or reconfig */
+		ts.tv_sec = time(NULL) + 1;
+		slurm_cond_timedwait(&user_lane_cond, &user_lane_mutex, &ts);
+	}
+	user_lane_cnt++;
+	slurm_mutex_unlock(&user_lane_mutex);
+	END_TIMER;
+
+	return DELTA_TIMER;
+}
+
+extern void user_lane_exit(void)
+{
+	slurm_mutex_lock(&user_lane_mutex);
+	if (user_lane_cnt)
+		user_lane_cnt--;
+	slurm_cond_signal(&user_lane_cond);
+	slurm_mutex_unlock(&user_lane_mutex);
+}
+
+extern uint16_t user_lane_active(void)
+{
+	uint16_t cnt;
+
+	slurm_mutex_lock(&user_lane_mutex);
+	cnt = user_lane_cnt;
+	slurm_mutex_unlock(&user_lane_mutex);
+
+	return cnt;
+}
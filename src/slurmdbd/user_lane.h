@@ -0,0 +1,74 @@
+/*****************************************************************************\
+ *  user_lane.h - limit on concurrent RPCs from users other than slurmctld
+ *****************************************************************************
+ *  Copyright (C) 2018 SchedMD LLC.
+ *
+ *  This file is part of Slurm, a resource management program.
+ *  For details, see <https://slurm.schedmd.com/>.
+ *  Please also read the included file: DISCLAIMER.
+ *
+ *  Slurm is free software; you can redistribute it and/or modify it under
+ *  the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  In addition, as a special exception, the copyright holders give permission
+ *  to link the code of portions of this program with the OpenSSL library under
+ *  certain conditions as described in each individual source file, and
+ *  distribute linked combinations including the two. You must obey the GNU
+ *  General Public License in all respects for all of the code used other than
+ *  OpenSSL. If you modify file(s) with this exception, you may extend this
+ *  exception to your version of the file(s), but you are not obligated to do
+ *  so. If you do not wish to do so, delete this exception statement from your
+ *  version.  If you delete this exception statement from all source files in
+ *  the program, then also delete it here.
+ *
+ *  Slurm is distributed in the hope that it will be useful, but WITHOUT ANY
+ *  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *  FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ *  details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with Slurm; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA.
+\*****************************************************************************/
+
+#ifndef _USER_LANE_H
+#define _USER_LANE_H
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <time.h>
+
+/*
+ * RPCs from slurmctld (the controller lane) are never throttled. RPCs from
+ * any other connection (the user lane: sacct, sreport, sacctmgr...) are
+ * limited to MaxUserRPCs running at a time so a burst of expensive queries
+ * can not tie up every database connection and delay job accounting.
+ */
+
+/*
+ * Return true if an RPC is subject to the user lane limit
+ * IN msg_type - DBD_* type of the RPC
+ * IN ctld_conn - RPC arrived on a registered slurmctld connection
+ * IN in_mult_msg - RPC is part of a DBD_SEND_MULT_MSG already in the lane
+ * IN slurm_user - RPC was sent by root or SlurmUser
+ */
+extern bool user_lane_limited(uint16_t msg_type, bool ctld_conn,
+			      bool in_mult_msg, bool slurm_user);
+
+/*
+ * Wait for a free user lane slot
+ * IN max_rpcs - MaxUserRPCs, zero for no limit
+ * IN shutdown - stop waiting once *shutdown is set
+ * RET usecs spent waiting
+ */
+extern uint64_t user_lane_enter(uint16_t max_rpcs, time_t *shutdown);
+
+/* Release the slot taken by user_lane_enter() */
+extern void user_lane_exit(void);
+
+/* Return the count of RPCs currently in the user lane */
+extern uint16_t user_lane_active(void);
+
+#endif
@@ -0,0 +1,170 @@
+/*****************************************************************************\
+ *  bcast-cache-test.c - test the slurmd sbcast block cache
+ *****************************************************************************
+ *  Copyright (C) 2018 SchedMD LLC.
+ *
+ *  This file is part of Slurm, a resource management program.
+ *  For details, see <https://slurm.schedmd.com/>.
+ *  Please also read the included file: DISCLAIMER.
+ *
+ *  Slurm is free software; you can redistribute it and/or modify it under
+ *  the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  In addition, as a special exception, the copyright holders give permission
+ *  to link the code of portions of this program with the OpenSSL library under
+ *  certain conditions as described in each individual source file, and
+ *  distribute linked combinations including the two. You must obey the GNU
+ *  General Public License in all respects for all of the code used other than
+ *  OpenSSL. If you modify file(s) with this exception, you may extend this
+ *  exception to your version of the file(s), but you are not obligated to do
+ *  so. If you do not wish to do so, delete this exception statement from your
+ *  version.  If you delete this exception statement from all source files in
+ *  the program, then also delete it here.
+ *
+ *  Slurm is distributed in the hope that it will be useful, but WITHOUT ANY
+ *  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *  FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ *  details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with Slurm; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA.
+\*****************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include "slurm/slurm_errno.h"
+#include "src/bcast/sha256.h"
+#include "src/common/xmalloc.h"
+#include "src/common/xstring.h"
+#include "src/slurmd/slurmd/bcast_cache.h"
+#include "testsuite/dejagnu.h"
+
+#define TEST(_tst, _msg) do {		\
+	if (! (_tst))			\
+		fail( _msg );		\
+	else				\
+		pass( _msg );		\
+} while (0)
+
+#define BLOCK_SIZE	(300 * 1024)	/* CacheSize=1M holds three */
+#define TEST_UID	1000
+
+static char *cache_dir = NULL;
+static char *blocks[4];
+static char hashes[4][SHA256_HEX_LEN];
+
+static char *_block_path(int inx)
+{
+	return xstrdup_printf("%s/%u/%s", cache_dir, TEST_UID, hashes[inx]);
+}
+
+static bool _cached(int inx)
+{
+	char *path = _block_path(inx);
+	bool rc = (access(path, F_OK) == 0);
+
+	xfree(path);
+	return rc;
+}
+
+/* Set a cached block's last use time, seconds in the past */
+static void _age_block(int inx, int age)
+{
+	char *path = _block_path(inx);
+	struct timeval tv[2];
+
+	gettimeofday(&tv[0], NULL);
+	tv[0].tv_sec -= age;
+	tv[1] = tv[0];
+	if (utimes(path, tv))
+		fail("utimes");
+	xfree(path);
+}
+
+int main(int argc, char *argv[])
+{
+	char tmp_dir[] = "/tmp/bcast-cache-test.XXXXXX";
+	char *conf_path, *data = NULL, *cmd;
+	FILE *conf;
+	int i;
+
+	if (!mkdtemp(tmp_dir)) {
+		fail("mkdtemp");
+		totals();
+		return failed;
+	}
+	cache_dir = xstrdup_printf("%s/cache", tmp_dir);
+	conf_path = xstrdup_printf("%s/slurm.conf", tmp_dir);
+	conf = fopen(conf_path, "w");
+	fprintf(conf, "ClusterName=test\n");
+	fprintf(conf, "SlurmctldHost=localhost\n");
+	fprintf(conf, "PluginDir=%s\n", tmp_dir);
+	fprintf(conf, "SbcastParameters=CacheDir=%s,CacheSize=1M\n",
+		cache_dir);
+	fclose(conf);
+	setenv("SLURM_CONF", conf_path, 1);
+
+	for (i = 0; i < 4; i++) {
+		blocks[i] = xmalloc(BLOCK_SIZE);
+		memset(blocks[i], 'a' + i, BLOCK_SIZE);
+		sha256_hex(blocks[i], BLOCK_SIZE, hashes[i]);
+	}
+
+	bcast_cache_config();
+
+	note("Testing store and load");
+	bcast_cache_store(TEST_UID, hashes[0], blocks[0], BLOCK_SIZE);
+	TEST(_cached(0), "block stored");
+	TEST(bcast_cache_load(TEST_UID, hashes[0], BLOCK_SIZE, &data) ==
+	     SLURM_SUCCESS, "block loaded");
+	TEST(data && !memcmp(data, blocks[0], BLOCK_SIZE), "block contents");
+	xfree(data);
+
+	note("Testing load misses");
+	TEST(bcast_cache_load(TEST_UID + 1, hashes[0], BLOCK_SIZE, &data) ==
+	     SLURM_ERROR, "other user's block not served");
+	TEST(bcast_cache_load(TEST_UID, hashes[0], BLOCK_SIZE - 1, &data) ==
+	     SLURM_ERROR, "length mismatch not served");
+	TEST(bcast_cache_load(TEST_UID, hashes[1], BLOCK_SIZE, &data) ==
+	     SLURM_ERROR, "uncached block not served");
+	TEST(bcast_cache_load(TEST_UID, "../../etc/passwd", BLOCK_SIZE,
+			      &data) == SLURM_ERROR, "invalid hash rejected");
+	bcast_cache_store(TEST_UID, "0123", blocks[1], BLOCK_SIZE);
+	TEST(!_cached(1), "invalid hash not stored");
+
+	note("Testing eviction");
+	bcast_cache_store(TEST_UID, hashes[1], blocks[1], BLOCK_SIZE);
+	bcast_cache_store(TEST_UID, hashes[2], blocks[2], BLOCK_SIZE);
+	_age_block(0, 300);
+	_age_block(1, 200);
+	_age_block(2, 100);
+	/* A hit makes block 0 the most recently used */
+	TEST(bcast_cache_load(TEST_UID, hashes[0], BLOCK_SIZE, &data) ==
+	     SLURM_SUCCESS, "block loaded");
+	xfree(data);
+	bcast_cache_store(TEST_UID, hashes[3], blocks[3], BLOCK_SIZE);
+	TEST(_cached(0), "recently used block kept");
+	TEST(!_cached(1), "least recently used block evicted");
+	TEST(_cached(2), "newer block kept");
+	TEST(_cached(3), "new block stored");
+
+	for (i = 0; i < 4; i++)
+		xfree(blocks[i]);
+	cmd = xstrdup_printf("rm -rf %s", tmp_dir);
+	if (system(cmd))
+		note("unable to remove %s", tmp_dir);
+	xfree(cmd);
+	xfree(conf_path);
+	xfree(cache_dir);
+
+	totals();
+	return failed;
+}
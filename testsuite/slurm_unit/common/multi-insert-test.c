@@ -0,0 +1,87 @@
+/*****************************************************************************\
+ *  multi-insert-test.c - test the accounting storage multi-row insert builder
+ *****************************************************************************
+ *  Copyright (C) 2018 SchedMD LLC.
+ *
+ *  This file is part of Slurm, a resource management program.
+ *  For details, see <https://slurm.schedmd.com/>.
+ *  Please also read the included file: DISCLAIMER.
+ *
+ *  Slurm is free software; you can redistribute it and/or modify it under
+ *  the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  In addition, as a special exception, the copyright holders give permission
+ *  to link the code of portions of this program with the OpenSSL library under
+ *  certain conditions as described in each individual source file, and
+ *  distribute linked combinations including the two. You must obey the GNU
+ *  General Public License in all respects for all of the code used other than
+ *  OpenSSL. If you modify file(s) with this exception, you may extend this
+ *  exception to your version of the file(s), but you are not obligated to do
+ *  so. If you do not wish to do so, delete this exception statement from your
+ *  version.  If you delete this exception statement from all source files in
+ *  the program, then also delete it here.
+ *
+ *  Slurm is distributed in the hope that it will be useful, but WITHOUT ANY
+ *  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *  FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ *  details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with Slurm; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA.
+\*****************************************************************************/
+
+#include <string.h>
+
+#include "src/common/list.h"
+#include "src/common/slurm_protocol_defs.h"
+#include "src/common/xmalloc.h"
+#include "src/common/xstring.h"
+#include "src/plugins/accounting_storage/common/multi_insert.h"
+
+/* dejagnu.h defines a wait() which conflicts with the one of <sys/wait.h> */
+#define wait dejagnu_wait
+#include "testsuite/dejagnu.h"
+#undef wait
+
+#define TEST(_tst, _msg) do {		\
+	if (! (_tst))			\
+		fail( _msg );		\
+	else				\
+		pass( _msg );		\
+} while (0)
+
+#define PREFIX "insert into \"c_step_table\" (job_db_inx, id_step) values "
+#define SUFFIX " on duplicate key update id_step=VALUES(id_step);"
+
+int main(int argc, char *argv[])
+{
+	List rows = list_create(slurm_destroy_char);
+	char *query;
+
+	note("Testing empty inserts");
+	TEST(!build_multi_insert(PREFIX, NULL, SUFFIX), "no list, no query");
+	TEST(!build_multi_insert(PREFIX, rows, SUFFIX), "no rows, no query");
+
+	note("Testing one row");
+	list_append(rows, xstrdup("(1, 0)"));
+	query = build_multi_insert(PREFIX, rows, SUFFIX);
+	TEST(!xstrcmp(query, PREFIX "(1, 0)" SUFFIX), "one row query");
+	xfree(query);
+
+	note("Testing several rows");
+	list_append(rows, xstrdup("(1, -2)"));
+	list_append(rows, xstrdup("(2, 0)"));
+	query = build_multi_insert(PREFIX, rows, SUFFIX);
+	TEST(!xstrcmp(query, PREFIX "(1, 0), (1, -2), (2, 0)" SUFFIX),
+	     "rows in order, comma separated");
+	xfree(query);
+	TEST(list_count(rows) == 3, "rows left in the list");
+
+	FREE_NULL_LIST(rows);
+
+	totals();
+	return failed;
+}
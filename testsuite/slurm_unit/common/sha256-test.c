@@ -0,0 +1,99 @@
+/*****************************************************************************\
+ *  sha256-test.c - test SHA-256 digests against known answers
+ *****************************************************************************
+ *  Copyright (C) 2018 SchedMD LLC.
+ *
+ *  This file is part of Slurm, a resource management program.
+ *  For details, see <https://slurm.schedmd.com/>.
+ *  Please also read the included file: DISCLAIMER.
+ *
+ *  Slurm is free software; you can redistribute it and/or modify it under
+ *  the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  In addition, as a special exception, the copyright holders give permission
+ *  to link the code of portions of this program with the OpenSSL library under
+ *  certain conditions as described in each individual source file, and
+ *  distribute linked combinations including the two. You must obey the GNU
+ *  General Public License in all respects for all of the code used other than
+ *  OpenSSL. If you modify file(s) with this exception, you may extend this
+ *  exception to your version of the file(s), but you are not obligated to do
+ *  so. If you do not wish to do so, delete this exception statement from your
+ *  version.  If you delete this exception statement from all source files in
+ *  the program, then also delete it here.
+ *
+ *  Slurm is distributed in the hope that it will be useful, but WITHOUT ANY
+ *  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *  FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ *  details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with Slurm; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA.
+\*****************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "src/bcast/sha256.h"
+#include "src/common/xmalloc.h"
+#include "testsuite/dejagnu.h"
+
+#define TEST(_tst, _msg) do {		\
+	if (! (_tst))			\
+		fail( _msg );		\
+	else				\
+		pass( _msg );		\
+} while (0)
+
+/* Test vectors from FIPS 180-4 examples and NIST CAVP */
+static struct {
+	char *data;
+	char *hash;
+} vectors[] = {
+	{ "",
+	  "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855" },
+	{ "abc",
+	  "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad" },
+	{ "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq",
+	  "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1" },
+	{ NULL, NULL }
+};
+
+/* Digest of len bytes of 'a', to cover each padding boundary */
+static void _test_repeat(size_t len, char *expect)
+{
+	char hex[SHA256_HEX_LEN];
+	char *data = xmalloc(len + 1);
+
+	memset(data, 'a', len);
+	sha256_hex(data, len, hex);
+	TEST(!strcmp(hex, expect), "repeated 'a'");
+	xfree(data);
+}
+
+int main(int argc, char *argv[])
+{
+	char hex[SHA256_HEX_LEN];
+	int i;
+
+	note("Testing known answers");
+	for (i = 0; vectors[i].data; i++) {
+		sha256_hex(vectors[i].data, strlen(vectors[i].data), hex);
+		TEST(!strcmp(hex, vectors[i].hash), vectors[i].data);
+	}
+
+	note("Testing block padding boundaries");
+	_test_repeat(55,
+	  "9f4390f8d30c2dd92ec9f095b65e2b9ae9b0a925a5258e241c9f1e910f734318");
+	_test_repeat(56,
+	  "b35439a4ac6f0948b6d6f9e3c6af0f5f590ce20f1bde7090ef7970686ec6738a");
+	_test_repeat(64,
+	  "ffe054fe7ae0cb6dc65c3af9b61d5209f439851db43d0ba5997337df154668eb");
+	_test_repeat(1000000,
+	  "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0");
+
+	totals();
+	return failed;
+}
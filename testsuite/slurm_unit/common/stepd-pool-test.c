@@ -0,0 +1,193 @@
+/*****************************************************************************\
+ *  stepd-pool-test.c - test the slurmd pool of pre-forked slurmstepds
+ *****************************************************************************
+ *  Copyright (C) 2018 SchedMD LLC.
+ *
+ *  This file is part of Slurm, a resource management program.
+ *  For details, see <https://slurm.schedmd.com/>.
+ *  Please also read the included file: DISCLAIMER.
+ *
+ *  Slurm is free software; you can redistribute it and/or modify it under
+ *  the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  In addition, as a special exception, the copyright holders give permission
+ *  to link the code of portions of this program with the OpenSSL library under
+ *  certain conditions as described in each individual source file, and
+ *  distribute linked combinations including the two. You must obey the GNU
+ *  General Public License in all respects for all of the code used other than
+ *  OpenSSL. If you modify file(s) with this exception, you may extend this
+ *  exception to your version of the file(s), but you are not obligated to do
+ *  so. If you do not wish to do so, delete this exception statement from your
+ *  version.  If you delete this exception statement from all source files in
+ *  the program, then also delete it here.
+ *
+ *  Slurm is distributed in the hope that it will be useful, but WITHOUT ANY
+ *  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *  FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ *  details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with Slurm; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA.
+\*****************************************************************************/
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "slurm/slurm_errno.h"
+#include "src/common/xmalloc.h"
+#include "src/common/xstring.h"
+#include "src/slurmd/slurmd/stepd_pool.h"
+#include "testsuite/dejagnu.h"
+
+#define TEST(_tst, _msg) do {		\
+	if (! (_tst))			\
+		fail( _msg );		\
+	else				\
+		pass( _msg );		\
+} while (0)
+
+#define POOL_SIZE 3
+
+static pthread_mutex_t spawn_mutex = PTHREAD_MUTEX_INITIALIZER;
+static int spawn_cnt = 0;
+static bool spawn_fail = false;
+static int spawn_fds[POOL_SIZE * 2];	/* of the last POOL_SIZE spawned */
+
+/* Stands in for req.c, a pipe takes the place of a slurmstepd */
+extern int stepd_pool_spawn(int *to_stepd_fd, int *to_slurmd_fd)
+{
+	int fd[2];
+
+	slurm_mutex_lock(&spawn_mutex);
+	spawn_cnt++;
+	if (spawn_fail || pipe(fd)) {
+		slurm_mutex_unlock(&spawn_mutex);
+		return SLURM_ERROR;
+	}
+	spawn_fds[((spawn_cnt - 1) % POOL_SIZE) * 2] = fd[0];
+	spawn_fds[((spawn_cnt - 1) % POOL_SIZE) * 2 + 1] = fd[1];
+	slurm_mutex_unlock(&spawn_mutex);
+	*to_stepd_fd = fd[1];
+	*to_slurmd_fd = fd[0];
+
+	return SLURM_SUCCESS;
+}
+
+static int _spawn_cnt(void)
+{
+	int cnt;
+
+	slurm_mutex_lock(&spawn_mutex);
+	cnt = spawn_cnt;
+	slurm_mutex_unlock(&spawn_mutex);
+
+	return cnt;
+}
+
+/* Wait up to 5 seconds for the refill thread to reach the given counts */
+static bool _wait_for(int idle, int spawned)
+{
+	int i;
+
+	for (i = 0; i < 500; i++) {
+		if ((stepd_pool_idle() == idle) && (_spawn_cnt() >= spawned))
+			return true;
+		usleep(10000);
+	}
+	return false;
+}
+
+static bool _fd_open(int fd)
+{
+	return (fcntl(fd, F_GETFD) != -1);
+}
+
+int main(int argc, char *argv[])
+{
+	char tmp_dir[] = "/tmp/stepd-pool-test.XXXXXX";
+	char *conf_path;
+	FILE *conf;
+	int to_stepd = -1, to_slurmd = -1, i;
+	char c = 'x';
+
+	if (!mkdtemp(tmp_dir)) {
+		fail("mkdtemp");
+		totals();
+		return failed;
+	}
+	conf_path = xstrdup_printf("%s/slurm.conf", tmp_dir);
+	conf = fopen(conf_path, "w");
+	fprintf(conf, "ClusterName=test\n");
+	fprintf(conf, "SlurmctldHost=localhost\n");
+	fprintf(conf, "PluginDir=%s\n", tmp_dir);
+	fprintf(conf, "LaunchParameters=slurmstepd_prefork=%d\n", POOL_SIZE);
+	fclose(conf);
+	setenv("SLURM_CONF", conf_path, 1);
+
+	note("Testing pool fill");
+	stepd_pool_config();
+	TEST(_wait_for(POOL_SIZE, POOL_SIZE), "pool filled");
+	TEST(_spawn_cnt() == POOL_SIZE, "no extra slurmstepds spawned");
+
+	note("Testing take and refill");
+	TEST(stepd_pool_take(&to_stepd, &to_slurmd), "slurmstepd taken");
+	TEST((write(to_stepd, &c, 1) == 1) && (read(to_slurmd, &c, 1) == 1),
+	     "taken slurmstepd's pipes connected");
+	close(to_stepd);
+	close(to_slurmd);
+	TEST(_wait_for(POOL_SIZE, POOL_SIZE + 1), "pool refilled");
+	stepd_pool_launch_add(1500, true);
+	stepd_pool_launch_add(5000000, false);
+
+	note("Testing spawn failure");
+	slurm_mutex_lock(&spawn_mutex);
+	spawn_fail = true;
+	slurm_mutex_unlock(&spawn_mutex);
+	TEST(stepd_pool_take(&to_stepd, &to_slurmd), "slurmstepd taken");
+	TEST(_wait_for(POOL_SIZE - 1, POOL_SIZE + 2),
+	     "refill stopped on spawn failure");
+	usleep(100000);
+	TEST(_spawn_cnt() == POOL_SIZE + 2, "no spawn retried after failure");
+	close(to_stepd);
+	close(to_slurmd);
+
+	note("Testing empty pool");
+	TEST(stepd_pool_take(&to_stepd, &to_slurmd), "slurmstepd taken");
+	close(to_stepd);
+	close(to_slurmd);
+	TEST(stepd_pool_take(&to_stepd, &to_slurmd), "last slurmstepd taken");
+	close(to_stepd);
+	close(to_slurmd);
+	TEST(!stepd_pool_take(&to_stepd, &to_slurmd),
+	     "empty pool returns nothing");
+
+	note("Testing reconfigure and purge");
+	slurm_mutex_lock(&spawn_mutex);
+	spawn_fail = false;
+	spawn_cnt = 0;
+	slurm_mutex_unlock(&spawn_mutex);
+	stepd_pool_config();
+	TEST(_wait_for(POOL_SIZE, POOL_SIZE), "pool rebuilt on reconfigure");
+	stepd_pool_purge();
+	TEST(stepd_pool_idle() == 0, "pool empty after purge");
+	for (i = 0; i < (POOL_SIZE * 2); i++) {
+		if (_fd_open(spawn_fds[i]))
+			break;
+	}
+	TEST(i == (POOL_SIZE * 2), "idle slurmstepds' pipes closed");
+	TEST(!stepd_pool_take(&to_stepd, &to_slurmd),
+	     "nothing taken after purge");
+
+	unlink(conf_path);
+	rmdir(tmp_dir);
+	xfree(conf_path);
+
+	totals();
+	return failed;
+}
@@ -0,0 +1,116 @@
+/*****************************************************************************\
+ *  stmt-cache-test.c - test the database prepared statement cache
+ *****************************************************************************
+ *  Copyright (C) 2018 SchedMD LLC.
+ *
+ *  This file is part of Slurm, a resource management program.
+ *  For details, see <https://slurm.schedmd.com/>.
+ *  Please also read the included file: DISCLAIMER.
+ *
+ *  Slurm is free software; you can redistribute it and/or modify it under
+ *  the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  In addition, as a special exception, the copyright holders give permission
+ *  to link the code of portions of this program with the OpenSSL library under
+ *  certain conditions as described in each individual source file, and
+ *  distribute linked combinations including the two. You must obey the GNU
+ *  General Public License in all respects for all of the code used other than
+ *  OpenSSL. If you modify file(s) with this exception, you may extend this
+ *  exception to your version of the file(s), but you are not obligated to do
+ *  so. If you do not wish to do so, delete this exception statement from your
+ *  version.  If you delete this exception statement from all source files in
+ *  the program, then also delete it here.
+ *
+ *  Slurm is distributed in the hope that it will be useful, but WITHOUT ANY
+ *  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *  FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ *  details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with Slurm; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA.
+\*****************************************************************************/
+
+#include "src/common/xmalloc.h"
+#include "src/database/stmt_cache.h"
+#include "testsuite/dejagnu.h"
+
+#define TEST(_tst, _msg) do {		\
+	if (! (_tst))			\
+		fail( _msg );		\
+	else				\
+		pass( _msg );		\
+} while (0)
+
+#define QUERY_1 "update step_table set state=? where job_db_inx=?"
+#define QUERY_2 "update job_table set state=? where job_db_inx=?"
+
+static int closed = 0;
+
+static void _stmt_close(void *stmt)
+{
+	closed++;
+	xfree(stmt);
+}
+
+int main(int argc, char *argv[])
+{
+	stmt_cache_t *cache = stmt_cache_create();
+	db_stmt_t *db_stmt, *db_stmt2;
+	time_t log_time;
+
+	note("Testing lookups");
+	TEST(!stmt_cache_find(cache, QUERY_1), "empty cache misses");
+	db_stmt = stmt_cache_add(cache, QUERY_1, xmalloc(1), _stmt_close);
+	TEST(stmt_cache_find(cache, QUERY_1) == db_stmt, "added stmt found");
+	TEST(!stmt_cache_find(cache, QUERY_2), "other query misses");
+	db_stmt2 = stmt_cache_add(cache, QUERY_2, xmalloc(1), _stmt_close);
+	TEST(stmt_cache_find(cache, QUERY_2) == db_stmt2, "second stmt found");
+	TEST(stmt_cache_find(cache, QUERY_1) == db_stmt, "first stmt kept");
+	TEST((cache->hits == 3) && (cache->misses == 2), "hits and misses");
+
+	note("Testing execution statistics");
+	stmt_cache_exec(db_stmt, 100);
+	stmt_cache_exec(db_stmt, 300);
+	stmt_cache_exec(db_stmt, 200);
+	TEST(db_stmt->exec_cnt == 3, "executions counted");
+	TEST(db_stmt->exec_time == 600, "execution time summed");
+	TEST(db_stmt->exec_max_time == 300, "longest execution kept");
+
+	note("Testing periodic log");
+	cache->log_time -= 10;
+	log_time = cache->log_time;
+	stmt_cache_log(cache, 3600);
+	TEST(cache->log_time == log_time, "not logged within the interval");
+	stmt_cache_log(cache, 5);
+	TEST(cache->log_time > log_time, "logged after the interval");
+	TEST(cache->log_lookups == 5, "lookups at log time recorded");
+	cache->log_time -= 10;
+	log_time = cache->log_time;
+	stmt_cache_log(cache, 5);
+	TEST(cache->log_time == log_time, "not logged when unused");
+
+	note("Testing removal");
+	stmt_cache_remove(cache, QUERY_1);
+	TEST(closed == 1, "removed stmt closed");
+	TEST(!stmt_cache_find(cache, QUERY_1), "removed stmt gone");
+	TEST(stmt_cache_find(cache, QUERY_2) == db_stmt2, "other stmt kept");
+	stmt_cache_remove(cache, QUERY_1);
+	TEST(closed == 1, "removing a missing stmt is harmless");
+
+	note("Testing flush");
+	stmt_cache_add(cache, QUERY_1, xmalloc(1), _stmt_close);
+	stmt_cache_flush(cache);
+	TEST(closed == 3, "flush closes all stmts");
+	TEST(!stmt_cache_find(cache, QUERY_2), "cache empty after flush");
+	TEST(cache->hits == 4, "statistics kept across flush");
+
+	stmt_cache_add(cache, QUERY_1, xmalloc(1), _stmt_close);
+	stmt_cache_destroy(cache);
+	TEST(closed == 4, "destroy closes all stmts");
+
+	totals();
+	return failed;
+}
@@ -0,0 +1,246 @@
+/*****************************************************************************\
+ *  topo-leaf-test.c - test and time the leaf switch node lists
+ *****************************************************************************
+ *  Copyright (C) 2018 SchedMD LLC.
+ *
+ *  This file is part of Slurm, a resource management program.
+ *  For details, see <https://slurm.schedmd.com/>.
+ *  Please also read the included file: DISCLAIMER.
+ *
+ *  Slurm is free software; you can redistribute it and/or modify it under
+ *  the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  In addition, as a special exception, the copyright holders give permission
+ *  to link the code of portions of this program with the OpenSSL library under
+ *  certain conditions as described in each individual source file, and
+ *  distribute linked combinations including the two. You must obey the GNU
+ *  General Public License in all respects for all of the code used other than
+ *  OpenSSL. If you modify file(s) with this exception, you may extend this
+ *  exception to your version of the file(s), but you are not obligated to do
+ *  so. If you do not wish to do so, delete this exception statement from your
+ *  version.  If you delete this exception statement from all source files in
+ *  the program, then also delete it here.
+ *
+ *  Slurm is distributed in the hope that it will be useful, but WITHOUT ANY
+ *  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *  FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ *  details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with Slurm; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA.
+\*****************************************************************************/
+
+/*
+ * Models a three level fat tree and checks that the per switch counts built
+ * from the leaf node lists (switch_leaf_counts) match the ones built by
+ * intersecting every switch's node bitmap with the available nodes, as
+ * select/cons_res does when the tree is not strict. Both passes are timed.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "src/common/bitstring.h"
+#include "src/common/slurm_topology.h"
+#include "src/common/timers.h"
+#include "src/common/xmalloc.h"
+
+/* dejagnu.h defines a wait() which conflicts with the one of <sys/wait.h> */
+#define wait dejagnu_wait
+#include "testsuite/dejagnu.h"
+#undef wait
+
+#define TEST(_tst, _msg) do {		\
+	if (! (_tst))			\
+		fail( _msg );		\
+	else				\
+		pass( _msg );		\
+} while (0)
+
+#define NODE_CNT	50000
+#define LEAF_NODES	40			/* nodes per leaf switch */
+#define LEAF_CNT	(NODE_CNT / LEAF_NODES)
+#define SPINE_CNT	50
+#define JOB_CNT		20			/* availability maps timed */
+
+/* Build leaves 0..LEAF_CNT-1, spines after them and a single root last */
+static void _build_fat_tree(void)
+{
+	struct switch_record *sw;
+	int i, spine, root;
+
+	switch_record_cnt = LEAF_CNT + SPINE_CNT + 1;
+	switch_record_table = xmalloc(sizeof(struct switch_record) *
+				      switch_record_cnt);
+	switch_levels = 2;
+	root = switch_record_cnt - 1;
+
+	for (i = LEAF_CNT; i < switch_record_cnt; i++) {
+		sw = &switch_record_table[i];
+		sw->level = (i == root) ? 2 : 1;
+		sw->parent = (i == root) ? NO_VAL16 : root;
+		sw->node_bitmap = bit_alloc(NODE_CNT);
+	}
+	for (i = 0; i < LEAF_CNT; i++) {
+		sw = &switch_record_table[i];
+		spine = LEAF_CNT + (i % SPINE_CNT);
+		sw->level = 0;
+		sw->parent = spine;
+		sw->node_bitmap = bit_alloc(NODE_CNT);
+		bit_nset(sw->node_bitmap, i * LEAF_NODES,
+			 (i + 1) * LEAF_NODES - 1);
+		bit_or(switch_record_table[spine].node_bitmap,
+		       sw->node_bitmap);
+		bit_or(switch_record_table[root].node_bitmap,
+		       sw->node_bitmap);
+		switch_leaf_index_build(i);
+	}
+	switch_tree_strict = true;
+}
+
+static void _free_fat_tree(void)
+{
+	int i;
+
+	for (i = 0; i < switch_record_cnt; i++) {
+		FREE_NULL_BITMAP(switch_record_table[i].node_bitmap);
+		xfree(switch_record_table[i].node_index);
+	}
+	xfree(switch_record_table);
+	switch_record_cnt = 0;
+	switch_tree_strict = false;
+}
+
+/* The counting pass of _eval_nodes_topo() without the leaf lists */
+static void _bitmap_counts(bitstr_t *node_map, uint16_t *cpu_cnt,
+			   int *switches_cpu_cnt, int *switches_node_cnt,
+			   bitstr_t *avail_nodes_bitmap)
+{
+	bitstr_t *switch_bitmap;
+	int i, j, first, last;
+
+	for (j = 0; j < switch_record_cnt; j++) {
+		switch_bitmap = bit_copy(switch_record_table[j].node_bitmap);
+		bit_and(switch_bitmap, node_map);
+		bit_or(avail_nodes_bitmap, switch_bitmap);
+		switches_node_cnt[j] = bit_set_count(switch_bitmap);
+		first = bit_ffs(switch_bitmap);
+		if (first >= 0) {
+			last = bit_fls(switch_bitmap);
+			for (i = first; i <= last; i++) {
+				if (bit_test(switch_bitmap, i))
+					switches_cpu_cnt[j] += cpu_cnt[i];
+			}
+		}
+		bit_free(switch_bitmap);
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	bitstr_t *node_map[JOB_CNT], *bitmap_avail, *leaf_avail;
+	uint16_t *cpu_cnt;
+	int *bitmap_cpus, *bitmap_nodes, *leaf_cpus, *leaf_nodes;
+	long bitmap_usec = 0, leaf_usec = 0;
+	bool index_ok = true, counts_ok = true, avail_ok = true;
+	bool below_ok = true, super_set;
+	int i, j, k;
+	DEF_TIMERS;
+
+	srand(1);
+	_build_fat_tree();
+
+	note("Testing leaf node lists");
+	for (i = 0; i < LEAF_CNT; i++) {
+		struct switch_record *sw = &switch_record_table[i];
+		if ((sw->node_cnt != LEAF_NODES) ||
+		    (sw->node_index[0] != (i * LEAF_NODES)) ||
+		    (sw->node_index[LEAF_NODES - 1] !=
+		     ((i + 1) * LEAF_NODES - 1)))
+			index_ok = false;
+	}
+	TEST(index_ok, "leaf node lists match the leaf bitmaps");
+
+	for (j = 0; j < switch_record_cnt; j++) {
+		for (i = 0; i < LEAF_CNT; i++) {
+			super_set = bit_super_set(
+				switch_record_table[i].node_bitmap,
+				switch_record_table[j].node_bitmap);
+			if (switch_leaf_below(i, j) != super_set)
+				below_ok = false;
+		}
+	}
+	TEST(below_ok, "switch_leaf_below matches the switch bitmaps");
+
+	note("Testing switch counts on a %d node fat tree", NODE_CNT);
+	cpu_cnt = xmalloc(sizeof(uint16_t) * NODE_CNT);
+	for (i = 0; i < NODE_CNT; i++)
+		cpu_cnt[i] = 1 + (rand() % 64);
+	/* From empty to fully available, with whole leaves left out */
+	for (k = 0; k < JOB_CNT; k++) {
+		node_map[k] = bit_alloc(NODE_CNT);
+		for (i = 0; i < NODE_CNT; i++) {
+			if ((rand() % JOB_CNT) < k)
+				bit_set(node_map[k], i);
+		}
+		if (k % 2)
+			bit_nclear(node_map[k], 0, LEAF_NODES * 10 - 1);
+	}
+
+	bitmap_cpus  = xmalloc(sizeof(int) * switch_record_cnt);
+	bitmap_nodes = xmalloc(sizeof(int) * switch_record_cnt);
+	leaf_cpus    = xmalloc(sizeof(int) * switch_record_cnt);
+	leaf_nodes   = xmalloc(sizeof(int) * switch_record_cnt);
+	bitmap_avail = bit_alloc(NODE_CNT);
+	leaf_avail   = bit_alloc(NODE_CNT);
+	for (k = 0; k < JOB_CNT; k++) {
+		memset(bitmap_cpus,  0, sizeof(int) * switch_record_cnt);
+		memset(bitmap_nodes, 0, sizeof(int) * switch_record_cnt);
+		memset(leaf_cpus,    0, sizeof(int) * switch_record_cnt);
+		memset(leaf_nodes,   0, sizeof(int) * switch_record_cnt);
+		bit_nclear(bitmap_avail, 0, NODE_CNT - 1);
+		bit_nclear(leaf_avail, 0, NODE_CNT - 1);
+
+		START_TIMER;
+		_bitmap_counts(node_map[k], cpu_cnt, bitmap_cpus,
+			       bitmap_nodes, bitmap_avail);
+		END_TIMER;
+		bitmap_usec += DELTA_TIMER;
+
+		START_TIMER;
+		switch_leaf_counts(node_map[k], cpu_cnt, leaf_cpus,
+				   leaf_nodes, leaf_avail);
+		END_TIMER;
+		leaf_usec += DELTA_TIMER;
+
+		for (j = 0; j < switch_record_cnt; j++) {
+			if ((bitmap_cpus[j] != leaf_cpus[j]) ||
+			    (bitmap_nodes[j] != leaf_nodes[j]))
+				counts_ok = false;
+		}
+		if (!bit_equal(bitmap_avail, leaf_avail))
+			avail_ok = false;
+	}
+	TEST(counts_ok, "leaf list counts match the bitmap counts");
+	TEST(avail_ok, "leaf list available nodes match the bitmap ones");
+	note("%d switches, per job: bitmap scan %ld usec, leaf lists %ld usec",
+	     switch_record_cnt, bitmap_usec / JOB_CNT, leaf_usec / JOB_CNT);
+
+	for (k = 0; k < JOB_CNT; k++)
+		bit_free(node_map[k]);
+	bit_free(bitmap_avail);
+	bit_free(leaf_avail);
+	xfree(bitmap_cpus);
+	xfree(bitmap_nodes);
+	xfree(leaf_cpus);
+	xfree(leaf_nodes);
+	xfree(cpu_cnt);
+	_free_fat_tree();
+
+	totals();
+	return failed;
+}
@@ -0,0 +1,138 @@
+/*****************************************************************************\
+ *  user-lane-test.c - test the slurmdbd MaxUserRPCs limit
+ *****************************************************************************
+ *  Copyright (C) 2018 SchedMD LLC.
+ *
+ *  This file is part of Slurm, a resource management program.
+ *  For details, see <https://slurm.schedmd.com/>.
+ *  Please also read the included file: DISCLAIMER.
+ *
+ *  Slurm is free software; you can redistribute it and/or modify it under
+ *  the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  In addition, as a special exception, the copyright holders give permission
+ *  to link the code of portions of this program with the OpenSSL library under
+ *  certain conditions as described in each individual source file, and
+ *  distribute linked combinations including the two. You must obey the GNU
+ *  General Public License in all respects for all of the code used other than
+ *  OpenSSL. If you modify file(s) with this exception, you may extend this
+ *  exception to your version of the file(s), but you are not obligated to do
+ *  so. If you do not wish to do so, delete this exception statement from your
+ *  version.  If you delete this exception statement from all source files in
+ *  the program, then also delete it here.
+ *
+ *  Slurm is distributed in the hope that it will be useful, but WITHOUT ANY
+ *  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *  FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ *  details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with Slurm; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA.
+\*****************************************************************************/
+
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "src/common/macros.h"
+#include "src/common/slurmdbd_defs.h"
+#include "src/slurmdbd/user_lane.h"
+
+/* dejagnu.h defines a wait() which conflicts with the one of <sys/wait.h> */
+#define wait dejagnu_wait
+#include "testsuite/dejagnu.h"
+#undef wait
+
+#define TEST(_tst, _msg) do {		\
+	if (! (_tst))			\
+		fail( _msg );		\
+	else				\
+		pass( _msg );		\
+} while (0)
+
+static pthread_mutex_t waiter_mutex = PTHREAD_MUTEX_INITIALIZER;
+static bool waiter_done = false;
+static time_t shutdown_time = 0;
+
+static void *_waiter(void *arg)
+{
+	user_lane_enter(1, &shutdown_time);
+	slurm_mutex_lock(&waiter_mutex);
+	waiter_done = true;
+	slurm_mutex_unlock(&waiter_mutex);
+
+	return NULL;
+}
+
+static bool _waiter_done(void)
+{
+	bool done;
+
+	slurm_mutex_lock(&waiter_mutex);
+	done = waiter_done;
+	slurm_mutex_unlock(&waiter_mutex);
+
+	return done;
+}
+
+int main(int argc, char *argv[])
+{
+	pthread_t tid;
+
+	note("Testing which RPCs are limited");
+	TEST(user_lane_limited(DBD_GET_JOBS_COND, false, false, false),
+	     "user query limited");
+	TEST(!user_lane_limited(DBD_GET_JOBS_COND, true, false, false),
+	     "slurmctld connection not limited");
+	TEST(!user_lane_limited(DBD_GET_JOBS_COND, false, false, true),
+	     "SlurmUser not limited");
+	TEST(!user_lane_limited(DBD_STEP_START, false, true, false),
+	     "record of a DBD_SEND_MULT_MSG not limited");
+	TEST(!user_lane_limited(DBD_SEND_MULT_MSG, false, false, false),
+	     "DBD_SEND_MULT_MSG not limited");
+	TEST(!user_lane_limited(DBD_SEND_MULT_JOB_START, false, false, false),
+	     "DBD_SEND_MULT_JOB_START not limited");
+	TEST(!user_lane_limited(DBD_JOB_START, false, false, false),
+	     "DBD_JOB_START not limited");
+	TEST(!user_lane_limited(DBD_GET_STATS, false, false, false),
+	     "DBD_GET_STATS not limited");
+
+	note("Testing slot accounting");
+	user_lane_enter(0, &shutdown_time);
+	user_lane_enter(0, &shutdown_time);
+	TEST(user_lane_active() == 2, "unlimited lane counts RPCs");
+	user_lane_exit();
+	user_lane_exit();
+	TEST(user_lane_active() == 0, "slots released");
+	user_lane_exit();
+	TEST(user_lane_active() == 0, "extra release ignored");
+
+	note("Testing MaxUserRPCs=1");
+	user_lane_enter(1, &shutdown_time);
+	slurm_thread_create(&tid, _waiter, NULL);
+	usleep(200000);
+	TEST(!_waiter_done(), "second RPC waits");
+	user_lane_exit();
+	pthread_join(tid, NULL);
+	TEST(_waiter_done(), "second RPC runs after the first");
+	TEST(user_lane_active() == 1, "slot held by second RPC");
+
+	note("Testing shutdown");
+	waiter_done = false;
+	slurm_thread_create(&tid, _waiter, NULL);
+	usleep(200000);
+	TEST(!_waiter_done(), "third RPC waits");
+	slurm_mutex_lock(&waiter_mutex);
+	shutdown_time = time(NULL);
+	slurm_mutex_unlock(&waiter_mutex);
+	pthread_join(tid, NULL);
+	TEST(_waiter_done(), "waiting RPC released on shutdown");
+	user_lane_exit();
+	user_lane_exit();
+
+	totals();
+	return failed;
+}